@@ -0,0 +1,129 @@
+#!/usr/bin/env bash
+# Escalabilidade forte e fraca do mpi_enade sobre microdados sintéticos (gerador_enade.c).
+#   forte: o mesmo conjunto de LINHAS estudantes com 1, 2, 4, ... processos; speedup = T1/Tp, eficiência = speedup/p
+#   fraca: LINHAS estudantes por processo; eficiência = T1/Tp
+# Em cada execução confere o total de estudantes de ADS (pergunta 1) com o totalAlunos.c e as respostas de todas
+# as perguntas com as da execução com 1 processo. As tabelas também são gravadas em CSV.
+# Cada processo roda com uma thread (--threads=1), a não ser que -a traga outro --threads.
+#
+# Uso: ./bench_escalabilidade.sh [-p MAX_PROCESSOS] [-l LINHAS] [-r REPETICOES] [-m "OPÇÕES_MPIEXEC"] [-a "OPÇÕES_MPI_ENADE"] [-o SAIDA.csv]
+
+set -euo pipefail
+
+MAX_PROCESSOS=$(nproc)
+LINHAS=2000000
+REPETICOES=3
+OPCOES_MPIEXEC=""
+OPCOES_ENADE=""
+SAIDA_CSV="escalabilidade.csv"
+
+while getopts "p:l:r:m:a:o:h" opcao; do
+    case "$opcao" in
+        p) MAX_PROCESSOS=$OPTARG ;;
+        l) LINHAS=$OPTARG ;;
+        r) REPETICOES=$OPTARG ;;
+        m) OPCOES_MPIEXEC=$OPTARG ;;
+        a) OPCOES_ENADE=$OPTARG ;;
+        o) SAIDA_CSV=$OPTARG ;;
+        *) sed -n '2,8p' "$0"; exit 1 ;;
+    esac
+done
+
+# Número de threads fixo: sem ele, cada processo usaria OMP_NUM_THREADS e as curvas misturariam
+# a escala em processos com a variação de threads.
+if [[ "$OPCOES_ENADE" =~ --threads=([0-9]+) ]]; then
+    THREADS=${BASH_REMATCH[1]}
+else
+    THREADS=1
+    OPCOES_ENADE="$OPCOES_ENADE --threads=1"
+fi
+
+RAIZ=$(cd "$(dirname "$0")" && pwd)
+TRABALHO=$(mktemp -d "${TMPDIR:-/tmp}/bench_enade.XXXXXX")
+trap 'rm -rf "$TRABALHO"' EXIT
+
+echo "Compilando em $TRABALHO..."
+mpicc -O2 -march=native -fopenmp -pthread -o "$TRABALHO/mpi_enade" "$RAIZ"/mpi_enade.c "$RAIZ"/indice_cursos.c "$RAIZ"/parser_enade.c \
+    "$RAIZ"/cache_enade.c "$RAIZ"/perguntas_enade.c "$RAIZ"/leitor_enade.c "$RAIZ"/cruzamento_enade.c "$RAIZ"/grupos_cursos.c \
+    "$RAIZ"/exportacao_enade.c "$RAIZ"/metricas_enade.c "$RAIZ"/compactado_enade.c -lz
+gcc -O2 -o "$TRABALHO/gerador_enade" "$RAIZ/gerador_enade.c"
+gcc -O2 -o "$TRABALHO/totalAlunos" "$RAIZ/totalAlunos.c"
+
+# 1, 2, 4, ... até MAX_PROCESSOS (incluído mesmo se não for potência de 2).
+PROCESSOS=()
+for ((p = 1; p < MAX_PROCESSOS; p *= 2)); do PROCESSOS+=("$p"); done
+PROCESSOS+=("$MAX_PROCESSOS")
+
+# Gera os dados em $TRABALHO/<nome>/DADOS e imprime o total de ADS segundo o totalAlunos.
+gerar_dados() {
+    local nome=$1 linhas=$2
+    mkdir -p "$TRABALHO/$nome"
+    (cd "$TRABALHO/$nome" && "$TRABALHO/gerador_enade" --linhas="$linhas" > /dev/null &&
+        "$TRABALHO/totalAlunos" | sed -n 's/.*total de \([0-9]*\) vezes.*/\1/p')
+}
+
+# Roda o mpi_enade REPETICOES vezes e imprime o menor tempo. Aborta se as respostas não conferirem.
+medir() {
+    local nome=$1 processos=$2 esperado=$3 referencia=$4
+    local melhor=""
+    for ((r = 0; r < REPETICOES; r++)); do
+        local saida="$TRABALHO/$nome/saida_$processos.txt"
+        # shellcheck disable=SC2086
+        (cd "$TRABALHO/$nome" && mpiexec $OPCOES_MPIEXEC -n "$processos" "$TRABALHO/mpi_enade" $OPCOES_ENADE > "$saida")
+
+        local total
+        total=$(sed -n '/^1\./{n;s/.*Resposta: \([0-9]*\) estudantes.*/\1/p}' "$saida")
+        if [[ "$total" != "$esperado" ]]; then
+            echo "ERRO: $nome com $processos processos contou $total estudantes de ADS; o totalAlunos contou $esperado." >&2
+            exit 1
+        fi
+        sed '/^Análise concluída/,$d' "$saida" | grep -E '^([0-9]\.|   )' > "$saida.respostas"
+        if [[ -n "$referencia" ]] && ! cmp -s "$saida.respostas" "$referencia"; then
+            echo "ERRO: respostas de $nome com $processos processos diferem das de 1 processo." >&2
+            diff "$referencia" "$saida.respostas" | head >&2
+            exit 1
+        fi
+
+        local tempo
+        tempo=$(sed -n 's/^Análise concluída em \([0-9.]*\) segundos.*/\1/p' "$saida")
+        if [[ -z "$melhor" ]] || awk -v a="$tempo" -v b="$melhor" 'BEGIN { exit !(a < b) }'; then melhor=$tempo; fi
+    done
+    echo "$melhor"
+}
+
+echo "escala,processos,threads,linhas,tempo_s,speedup,eficiencia" > "$SAIDA_CSV"
+
+echo
+echo "Escalabilidade forte: $LINHAS estudantes, $THREADS thread(s) por processo, melhor de $REPETICOES execuções"
+esperado=$(gerar_dados forte "$LINHAS")
+printf "%10s %8s %12s %10s %12s\n" "processos" "threads" "tempo (s)" "speedup" "eficiência"
+tempo_1=""
+referencia=""
+for p in "${PROCESSOS[@]}"; do
+    tempo=$(medir forte "$p" "$esperado" "$referencia")
+    if [[ -z "$tempo_1" ]]; then
+        tempo_1=$tempo
+        referencia="$TRABALHO/forte/saida_1.txt.respostas"
+    fi
+    read -r speedup eficiencia < <(awk -v t1="$tempo_1" -v tp="$tempo" -v p="$p" 'BEGIN { s = t1 / tp; printf "%.2f %.2f\n", s, s / p }')
+    printf "%10d %8d %12.4f %10s %11.0f%%\n" "$p" "$THREADS" "$tempo" "${speedup}x" "$(awk -v e="$eficiencia" 'BEGIN { print e * 100 }')"
+    echo "forte,$p,$THREADS,$LINHAS,$tempo,$speedup,$eficiencia" >> "$SAIDA_CSV"
+done
+
+echo
+echo "Escalabilidade fraca: $LINHAS estudantes por processo, $THREADS thread(s) por processo, melhor de $REPETICOES execuções"
+printf "%10s %8s %12s %12s %12s\n" "processos" "threads" "estudantes" "tempo (s)" "eficiência"
+tempo_1=""
+for p in "${PROCESSOS[@]}"; do
+    linhas=$((LINHAS * p))
+    rm -rf "$TRABALHO/fraca"
+    esperado=$(gerar_dados fraca "$linhas")
+    tempo=$(medir fraca "$p" "$esperado" "")
+    [[ -z "$tempo_1" ]] && tempo_1=$tempo
+    eficiencia=$(awk -v t1="$tempo_1" -v tp="$tempo" 'BEGIN { printf "%.2f", t1 / tp }')
+    printf "%10d %8d %12d %12.4f %11.0f%%\n" "$p" "$THREADS" "$linhas" "$tempo" "$(awk -v e="$eficiencia" 'BEGIN { print e * 100 }')"
+    echo "fraca,$p,$THREADS,$linhas,$tempo,,$eficiencia" >> "$SAIDA_CSV"
+done
+
+echo
+echo "Totais de ADS conferidos com o totalAlunos.c em todas as execuções. Tabelas gravadas em $SAIDA_CSV."
@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "indice_cursos.h"
+
+// Micro-benchmark da verificação "este CO_CURSO é de ADS?": compara a varredura linear antiga
+// da lista de cursos com o índice em bitmap e em hash.
+// Com DADOS/microdados2021_arq1.txt presente usa os cursos reais do grupo 72 e todos os CO_CURSO
+// do arquivo como consultas; sem ele sorteia códigos no intervalo real de CO_CURSO.
+// Compilação: gcc -O2 -o bench_indice_cursos bench_indice_cursos.c indice_cursos.c
+
+#define NOME_ARQUIVO "DADOS/microdados2021_arq1.txt"
+#define CODIGO_GRUPO_ADS 72
+#define TAMANHO_BUFFER 1024
+#define CODIGO_CURSO_MAXIMO 5000000 // ordem de grandeza dos CO_CURSO do e-MEC
+#define CURSOS_ADS_SINTETICOS 1200
+#define CONSULTAS_SINTETICAS 5000000
+
+// Implementação antiga, mantida aqui só para comparação.
+static int eh_curso_de_ads_linear(int codigo_curso, const int* cursos_ads_lista, int qtd_cursos_ads) {
+    for (int i = 0; i < qtd_cursos_ads; i++) {
+        if (cursos_ads_lista[i] == codigo_curso) return 1;
+    }
+    return 0;
+}
+
+static double agora(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static int* adicionar(int* vetor, long long* quantidade, long long* capacidade, int valor) {
+    if (*quantidade == *capacidade) {
+        *capacidade = (*capacidade == 0) ? 1024 : *capacidade * 2;
+        vetor = realloc(vetor, *capacidade * sizeof(int));
+        if (!vetor) {
+            fprintf(stderr, "Falha ao alocar memória.\n");
+            exit(1);
+        }
+    }
+    vetor[(*quantidade)++] = valor;
+    return vetor;
+}
+
+int main(void) {
+    int* cursos_ads_lista = NULL;
+    long long qtd_cursos_ads = 0, capacidade_cursos = 0;
+    int* consultas = NULL;
+    long long qtd_consultas = 0, capacidade_consultas = 0;
+
+    IndiceCursos conjunto;
+    indice_cursos_iniciar(&conjunto);
+
+    FILE* arquivo = fopen(NOME_ARQUIVO, "r");
+    if (arquivo) {
+        char linha[TAMANHO_BUFFER];
+        fgets(linha, sizeof(linha), arquivo); // cabeçalho
+        while (fgets(linha, sizeof(linha), arquivo)) {
+            int codigo_curso = 0, codigo_grupo = 0;
+            if (sscanf(linha, "%*[^;];%d;%*[^;];%*[^;];%*[^;];%d", &codigo_curso, &codigo_grupo) < 2) continue;
+            consultas = adicionar(consultas, &qtd_consultas, &capacidade_consultas, codigo_curso);
+            if (codigo_grupo == CODIGO_GRUPO_ADS && indice_cursos_inserir(&conjunto, codigo_curso) == 1) {
+                cursos_ads_lista = adicionar(cursos_ads_lista, &qtd_cursos_ads, &capacidade_cursos, codigo_curso);
+            }
+        }
+        fclose(arquivo);
+        printf("Dados reais de '%s': %lld cursos de ADS, %lld consultas.\n", NOME_ARQUIVO, qtd_cursos_ads, qtd_consultas);
+    } else {
+        srand(2021);
+        while (qtd_cursos_ads < CURSOS_ADS_SINTETICOS) {
+            int codigo = 1 + rand() % CODIGO_CURSO_MAXIMO;
+            if (indice_cursos_inserir(&conjunto, codigo) == 1) {
+                cursos_ads_lista = adicionar(cursos_ads_lista, &qtd_cursos_ads, &capacidade_cursos, codigo);
+            }
+        }
+        for (long long i = 0; i < CONSULTAS_SINTETICAS; i++) {
+            // metade das consultas cai em cursos de ADS, como num arquivo filtrado por grupo
+            int codigo = (i & 1) ? cursos_ads_lista[rand() % qtd_cursos_ads] : 1 + rand() % CODIGO_CURSO_MAXIMO;
+            consultas = adicionar(consultas, &qtd_consultas, &capacidade_consultas, codigo);
+        }
+        printf("'%s' não encontrado: %lld cursos de ADS sorteados em [1, %d], %lld consultas.\n",
+               NOME_ARQUIVO, qtd_cursos_ads, CODIGO_CURSO_MAXIMO, qtd_consultas);
+    }
+    if (qtd_consultas == 0) {
+        printf("Nenhuma consulta para medir.\n");
+        return 0;
+    }
+
+    IndiceCursos bitmap, hash;
+    indice_cursos_iniciar(&bitmap);
+    indice_cursos_iniciar(&hash);
+    for (long long i = 0; i < qtd_cursos_ads; i++) {
+        indice_cursos_inserir(&bitmap, cursos_ads_lista[i]);
+        indice_cursos_inserir(&hash, cursos_ads_lista[i]);
+    }
+    indice_cursos_finalizar(&bitmap, INDICE_BITMAP);
+    indice_cursos_finalizar(&hash, INDICE_HASH);
+
+    double inicio = agora();
+    long long achados_linear = 0;
+    for (long long i = 0; i < qtd_consultas; i++) achados_linear += eh_curso_de_ads_linear(consultas[i], cursos_ads_lista, (int)qtd_cursos_ads);
+    double tempo_linear = agora() - inicio;
+
+    inicio = agora();
+    long long achados_bitmap = 0;
+    for (long long i = 0; i < qtd_consultas; i++) achados_bitmap += indice_cursos_contem(&bitmap, consultas[i]);
+    double tempo_bitmap = agora() - inicio;
+
+    inicio = agora();
+    long long achados_hash = 0;
+    for (long long i = 0; i < qtd_consultas; i++) achados_hash += indice_cursos_contem(&hash, consultas[i]);
+    double tempo_hash = agora() - inicio;
+
+    if (achados_linear != achados_bitmap || achados_linear != achados_hash) {
+        fprintf(stderr, "Resultados diferentes: linear %lld, bitmap %lld, hash %lld\n", achados_linear, achados_bitmap, achados_hash);
+        return 1;
+    }
+
+    printf("%-16s %12s %14s %10s\n", "Estrutura", "Tempo (s)", "ns/consulta", "Speedup");
+    printf("%-16s %12.4f %14.2f %10.1fx\n", "Lista linear", tempo_linear, tempo_linear * 1e9 / qtd_consultas, 1.0);
+    printf("%-16s %12.4f %14.2f %10.1fx\n", "Bitmap", tempo_bitmap, tempo_bitmap * 1e9 / qtd_consultas, tempo_linear / tempo_bitmap);
+    printf("%-16s %12.4f %14.2f %10.1fx\n", "Hash", tempo_hash, tempo_hash * 1e9 / qtd_consultas, tempo_linear / tempo_hash);
+    printf("Consultas positivas: %lld de %lld. Bitmap: %zu KB, hash: %zu KB.\n", achados_linear, qtd_consultas,
+           bitmap.tamanho * sizeof(uint64_t) / 1024, hash.tamanho * sizeof(int32_t) / 1024);
+
+    indice_cursos_liberar(&conjunto);
+    indice_cursos_liberar(&bitmap);
+    indice_cursos_liberar(&hash);
+    free(cursos_ads_lista);
+    free(consultas);
+    return 0;
+}
@@ -0,0 +1,107 @@
+#include "cache_enade.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+int cache_caminho(const char* caminho_origem, char* destino, size_t tamanho) {
+    size_t comprimento = strlen(caminho_origem);
+    const char* ponto = strrchr(caminho_origem, '.');
+    const char* barra = strrchr(caminho_origem, '/');
+    if (ponto && (!barra || ponto > barra)) comprimento = (size_t)(ponto - caminho_origem); // troca a extensão
+    int escritos = snprintf(destino, tamanho, "%.*s%s", (int)comprimento, caminho_origem, CACHE_EXTENSAO);
+    return escritos > 0 && (size_t)escritos < tamanho;
+}
+
+static int mesma_origem(const CabecalhoCache* cabecalho, const struct stat* origem) {
+    return cabecalho->tamanho_origem == (uint64_t)origem->st_size &&
+           cabecalho->mtime_origem_segundos == (int64_t)origem->st_mtim.tv_sec &&
+           cabecalho->mtime_origem_nanossegundos == (int64_t)origem->st_mtim.tv_nsec;
+}
+
+EstadoCache cache_abrir(const char* caminho_origem, CacheColunar* cache) {
+    memset(cache, 0, sizeof(*cache));
+
+    char caminho[4096];
+    struct stat origem, info;
+    if (!cache_caminho(caminho_origem, caminho, sizeof(caminho)) || stat(caminho_origem, &origem) != 0) return CACHE_AUSENTE;
+
+    int descritor = open(caminho, O_RDONLY);
+    if (descritor < 0) return CACHE_AUSENTE;
+    if (fstat(descritor, &info) != 0 || (size_t)info.st_size < sizeof(CabecalhoCache)) {
+        close(descritor);
+        return CACHE_INVALIDO;
+    }
+
+    void* mapa = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, descritor, 0);
+    close(descritor); // o mapeamento continua válido sem o descritor
+    if (mapa == MAP_FAILED) return CACHE_INVALIDO;
+
+    const CabecalhoCache* cabecalho = mapa;
+    EstadoCache estado = CACHE_OK;
+    // num_linhas vem do arquivo: é limitado antes da multiplicação, senão um cabeçalho corrompido poderia
+    // estourar o produto, passar na conferência do tamanho e levar a leituras além do mapeamento.
+    uint64_t max_linhas = ((uint64_t)info.st_size - sizeof(CabecalhoCache)) / (sizeof(int32_t) + sizeof(uint8_t));
+    if (memcmp(cabecalho->assinatura, CACHE_ASSINATURA, sizeof(cabecalho->assinatura)) != 0 || cabecalho->versao != CACHE_VERSAO ||
+        cabecalho->num_linhas > max_linhas ||
+        (uint64_t)info.st_size != sizeof(CabecalhoCache) + cabecalho->num_linhas * (sizeof(int32_t) + sizeof(uint8_t))) {
+        estado = CACHE_INVALIDO;
+    } else if (!mesma_origem(cabecalho, &origem)) {
+        estado = CACHE_DESATUALIZADO;
+    }
+    if (estado != CACHE_OK) {
+        munmap(mapa, (size_t)info.st_size);
+        return estado;
+    }
+
+    madvise(mapa, (size_t)info.st_size, MADV_SEQUENTIAL);
+    cache->mapa = mapa;
+    cache->tamanho_mapa = (size_t)info.st_size;
+    cache->num_linhas = cabecalho->num_linhas;
+    cache->codigos_curso = (const int32_t*)((const char*)mapa + sizeof(CabecalhoCache));
+    cache->respostas = (const uint8_t*)(cache->codigos_curso + cabecalho->num_linhas);
+    return CACHE_OK;
+}
+
+void cache_fechar(CacheColunar* cache) {
+    if (cache->mapa) munmap(cache->mapa, cache->tamanho_mapa);
+    memset(cache, 0, sizeof(*cache));
+}
+
+int cache_gravar(const char* caminho_origem, const struct stat* origem, const int32_t* codigos_curso, const uint8_t* respostas, uint64_t num_linhas) {
+    char caminho[4096], caminho_temporario[4200];
+    if (!cache_caminho(caminho_origem, caminho, sizeof(caminho))) return 0;
+    snprintf(caminho_temporario, sizeof(caminho_temporario), "%s.tmp.%ld", caminho, (long)getpid());
+
+    CabecalhoCache cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    memcpy(cabecalho.assinatura, CACHE_ASSINATURA, sizeof(cabecalho.assinatura));
+    cabecalho.versao = CACHE_VERSAO;
+    cabecalho.num_linhas = num_linhas;
+    cabecalho.tamanho_origem = (uint64_t)origem->st_size;
+    cabecalho.mtime_origem_segundos = (int64_t)origem->st_mtim.tv_sec;
+    cabecalho.mtime_origem_nanossegundos = (int64_t)origem->st_mtim.tv_nsec;
+
+    FILE* arquivo = fopen(caminho_temporario, "wb");
+    if (!arquivo) return 0;
+    int ok = fwrite(&cabecalho, sizeof(cabecalho), 1, arquivo) == 1 &&
+             fwrite(codigos_curso, sizeof(int32_t), num_linhas, arquivo) == num_linhas &&
+             fwrite(respostas, sizeof(uint8_t), num_linhas, arquivo) == num_linhas;
+    ok = (fclose(arquivo) == 0) && ok;
+    if (!ok || rename(caminho_temporario, caminho) != 0) {
+        remove(caminho_temporario);
+        return 0;
+    }
+    return 1;
+}
+
+const char* cache_descricao_estado(EstadoCache estado) {
+    switch (estado) {
+        case CACHE_OK: return "ok";
+        case CACHE_AUSENTE: return "ausente";
+        case CACHE_DESATUALIZADO: return "desatualizado";
+        default: return "inválido";
+    }
+}
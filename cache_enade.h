@@ -0,0 +1,51 @@
+#ifndef CACHE_ENADE_H
+#define CACHE_ENADE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+// Cache binário colunar de um arquivo de dados (DADOS/microdados2021_arqN.txt -> DADOS/microdados2021_arqN.col).
+// Layout: CabecalhoCache, depois CO_CURSO de todas as linhas (int32) e por fim a resposta de cada linha (1 byte).
+// O cabeçalho guarda o tamanho e o mtime do .txt de origem; se o .txt mudar o cache passa a ser ignorado.
+
+#define CACHE_ASSINATURA "ENADECOL"
+#define CACHE_VERSAO 1
+#define CACHE_EXTENSAO ".col"
+
+typedef struct {
+    char assinatura[8];
+    uint32_t versao;
+    uint32_t reservado;
+    uint64_t num_linhas;
+    uint64_t tamanho_origem;
+    int64_t mtime_origem_segundos;
+    int64_t mtime_origem_nanossegundos;
+} CabecalhoCache;
+
+typedef enum {
+    CACHE_OK,
+    CACHE_AUSENTE,
+    CACHE_DESATUALIZADO, // o .txt foi alterado depois da conversão
+    CACHE_INVALIDO       // assinatura, versão ou tamanho não conferem
+} EstadoCache;
+
+typedef struct {
+    const int32_t* codigos_curso;
+    const uint8_t* respostas;
+    uint64_t num_linhas;
+    void* mapa;
+    size_t tamanho_mapa;
+} CacheColunar;
+
+// Monta o caminho do cache a partir do arquivo de origem. Retorna 0 se não couber em 'destino'.
+int cache_caminho(const char* caminho_origem, char* destino, size_t tamanho);
+// Mapeia o cache com mmap e confere se ele ainda corresponde ao arquivo de origem.
+EstadoCache cache_abrir(const char* caminho_origem, CacheColunar* cache);
+void cache_fechar(CacheColunar* cache);
+// Grava o cache de forma atômica (arquivo temporário + rename). 'origem' é o stat do .txt feito antes da leitura.
+// Retorna 0 em caso de erro.
+int cache_gravar(const char* caminho_origem, const struct stat* origem, const int32_t* codigos_curso, const uint8_t* respostas, uint64_t num_linhas);
+const char* cache_descricao_estado(EstadoCache estado);
+
+#endif
@@ -0,0 +1,220 @@
+#include "compactado_enade.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define TAMANHO_ENTRADA_COMPACTADA (1 << 20)
+#define TAMANHO_MAX_FIM_ZIP (22 + 65535) // registro de fim do diretório central mais o maior comentário
+
+#define ASSINATURA_MEMBRO_LOCAL 0x04034b50u
+#define ASSINATURA_DIRETORIO_CENTRAL 0x02014b50u
+#define ASSINATURA_FIM_DIRETORIO 0x06054b50u
+#define ASSINATURA_LOCALIZADOR_ZIP64 0x07064b50u
+#define ASSINATURA_FIM_DIRETORIO_ZIP64 0x06064b50u
+
+static uint16_t ler16(const unsigned char* p) { return (uint16_t)(p[0] | p[1] << 8); }
+static uint32_t ler32(const unsigned char* p) { return (uint32_t)ler16(p) | (uint32_t)ler16(p + 2) << 16; }
+static uint64_t ler64(const unsigned char* p) { return (uint64_t)ler32(p) | (uint64_t)ler32(p + 4) << 32; }
+
+static int ler_exato(int descritor, void* destino, size_t tamanho, off_t posicao) {
+    return pread(descritor, destino, tamanho, posicao) == (ssize_t)tamanho;
+}
+
+// Localiza o diretório central: o registro de fim fica nos últimos bytes do arquivo, antes do comentário.
+// Com mais de 65535 membros ou offsets acima de 4 GB, os valores verdadeiros estão no registro zip64.
+static int localizar_diretorio(int descritor, off_t* offset_diretorio, long long* tamanho_diretorio) {
+    struct stat info;
+    if (fstat(descritor, &info) != 0 || info.st_size < 22) return 0;
+    size_t tamanho_fim = (info.st_size < TAMANHO_MAX_FIM_ZIP) ? (size_t)info.st_size : TAMANHO_MAX_FIM_ZIP;
+    off_t inicio_fim = info.st_size - (off_t)tamanho_fim;
+    unsigned char* fim = malloc(tamanho_fim);
+    if (!fim || !ler_exato(descritor, fim, tamanho_fim, inicio_fim)) {
+        free(fim);
+        return 0;
+    }
+
+    int achou = 0;
+    for (size_t i = tamanho_fim - 22 + 1; i-- > 0;) {
+        if (ler32(fim + i) != ASSINATURA_FIM_DIRETORIO) continue;
+        *tamanho_diretorio = ler32(fim + i + 12);
+        *offset_diretorio = ler32(fim + i + 16);
+        achou = 1;
+        int saturado = ler16(fim + i + 10) == UINT16_MAX || ler32(fim + i + 12) == UINT32_MAX || ler32(fim + i + 16) == UINT32_MAX;
+        if (saturado && i >= 20 && ler32(fim + i - 20) == ASSINATURA_LOCALIZADOR_ZIP64) {
+            unsigned char zip64[56];
+            achou = ler_exato(descritor, zip64, sizeof(zip64), (off_t)ler64(fim + i - 20 + 8)) &&
+                    ler32(zip64) == ASSINATURA_FIM_DIRETORIO_ZIP64;
+            if (achou) {
+                *tamanho_diretorio = (long long)ler64(zip64 + 40);
+                *offset_diretorio = (off_t)ler64(zip64 + 48);
+            }
+        }
+        break;
+    }
+    free(fim);
+    return achou && *offset_diretorio + *tamanho_diretorio <= info.st_size;
+}
+
+// Pega os tamanhos e o offset de 64 bits do campo extra zip64, na ordem em que aparecem (só os que
+// estão saturados em 0xFFFFFFFF no registro do diretório).
+static void ler_extra_zip64(const unsigned char* extra, size_t tamanho, uint64_t* original, uint64_t* compactado, uint64_t* offset_local) {
+    for (size_t i = 0; i + 4 <= tamanho;) {
+        uint16_t id = ler16(extra + i), tamanho_campo = ler16(extra + i + 2);
+        if (i + 4 + tamanho_campo > tamanho) return;
+        if (id == 0x0001) {
+            const unsigned char* p = extra + i + 4;
+            const unsigned char* fim = p + tamanho_campo;
+            if (*original == UINT32_MAX && p + 8 <= fim) { *original = ler64(p); p += 8; }
+            if (*compactado == UINT32_MAX && p + 8 <= fim) { *compactado = ler64(p); p += 8; }
+            if (*offset_local == UINT32_MAX && p + 8 <= fim) *offset_local = ler64(p);
+            return;
+        }
+        i += 4 + (size_t)tamanho_campo;
+    }
+}
+
+static int termina_com(const char* nome, size_t tamanho_nome, const char* nome_base) {
+    size_t tamanho_base = strlen(nome_base);
+    if (tamanho_nome < tamanho_base || memcmp(nome + tamanho_nome - tamanho_base, nome_base, tamanho_base) != 0) return 0;
+    return tamanho_nome == tamanho_base || nome[tamanho_nome - tamanho_base - 1] == '/';
+}
+
+int zip_encontrar_membro(int descritor, const char* nome_base, MembroCompactado* membro) {
+    off_t offset_diretorio;
+    long long tamanho_diretorio;
+    if (!localizar_diretorio(descritor, &offset_diretorio, &tamanho_diretorio)) return 0;
+    unsigned char* diretorio = malloc((size_t)tamanho_diretorio + 1);
+    if (!diretorio || !ler_exato(descritor, diretorio, (size_t)tamanho_diretorio, offset_diretorio)) {
+        free(diretorio);
+        return 0;
+    }
+
+    int achou = 0;
+    for (long long i = 0; i + 46 <= tamanho_diretorio && ler32(diretorio + i) == ASSINATURA_DIRETORIO_CENTRAL;) {
+        const unsigned char* registro = diretorio + i;
+        uint16_t flags = ler16(registro + 8), metodo = ler16(registro + 10);
+        uint64_t compactado = ler32(registro + 20), original = ler32(registro + 24), offset_local = ler32(registro + 42);
+        size_t tamanho_nome = ler16(registro + 28), tamanho_extra = ler16(registro + 30), tamanho_comentario = ler16(registro + 32);
+        if (i + 46 + (long long)(tamanho_nome + tamanho_extra + tamanho_comentario) > tamanho_diretorio) break;
+        const char* nome = (const char*)registro + 46;
+
+        if (tamanho_nome < TAMANHO_MAX_NOME_MEMBRO && termina_com(nome, tamanho_nome, nome_base)) {
+            ler_extra_zip64(registro + 46 + tamanho_nome, tamanho_extra, &original, &compactado, &offset_local);
+            unsigned char local[30];
+            // Os dados começam depois do cabeçalho local, cujo campo extra pode diferir do diretório.
+            if (!(flags & 1) && (metodo == 0 || metodo == 8) && ler_exato(descritor, local, sizeof(local), (off_t)offset_local) &&
+                ler32(local) == ASSINATURA_MEMBRO_LOCAL) {
+                memcpy(membro->nome, nome, tamanho_nome);
+                membro->nome[tamanho_nome] = '\0';
+                membro->tipo = (metodo == 0) ? COMPACTACAO_ARMAZENADO : COMPACTACAO_DEFLATE;
+                membro->offset_dados = (off_t)offset_local + 30 + ler16(local + 26) + ler16(local + 28);
+                membro->tamanho_compactado = (long long)compactado;
+                membro->tamanho_original = (long long)original;
+                achou = 1;
+            }
+            break;
+        }
+        i += 46 + (long long)(tamanho_nome + tamanho_extra + tamanho_comentario);
+    }
+    free(diretorio);
+    return achou;
+}
+
+int gz_membro(int descritor, MembroCompactado* membro) {
+    unsigned char cabecalho[2];
+    struct stat info;
+    if (fstat(descritor, &info) != 0 || !ler_exato(descritor, cabecalho, sizeof(cabecalho), 0)) return 0;
+    if (cabecalho[0] != 0x1f || cabecalho[1] != 0x8b) return 0;
+    membro->nome[0] = '\0';
+    membro->tipo = COMPACTACAO_GZIP;
+    membro->offset_dados = 0;
+    membro->tamanho_compactado = (long long)info.st_size;
+    membro->tamanho_original = -1; // o ISIZE do fim do .gz é módulo 4 GB e só cobre o último membro
+    return 1;
+}
+
+int descompressor_iniciar(Descompressor* descompressor, int descritor, const MembroCompactado* membro) {
+    memset(descompressor, 0, sizeof(*descompressor));
+    descompressor->descritor = descritor;
+    descompressor->membro = *membro;
+    descompressor->posicao = membro->offset_dados;
+    descompressor->restante = membro->tamanho_compactado;
+    if (membro->tipo == COMPACTACAO_ARMAZENADO) return 1;
+
+    descompressor->entrada = malloc(TAMANHO_ENTRADA_COMPACTADA);
+    if (!descompressor->entrada) return 0;
+    // Janela negativa: deflate puro, sem cabeçalho (zip). +16: só aceita o formato gzip.
+    int janela = (membro->tipo == COMPACTACAO_DEFLATE) ? -MAX_WBITS : 16 + MAX_WBITS;
+    if (inflateInit2(&descompressor->fluxo, janela) != Z_OK) {
+        free(descompressor->entrada);
+        descompressor->entrada = NULL;
+        return 0;
+    }
+    descompressor->fluxo_iniciado = 1;
+    return 1;
+}
+
+void descompressor_liberar(Descompressor* descompressor) {
+    if (descompressor->fluxo_iniciado) inflateEnd(&descompressor->fluxo);
+    descompressor->fluxo_iniciado = 0;
+    free(descompressor->entrada);
+    descompressor->entrada = NULL;
+}
+
+size_t descompressor_ler(Descompressor* descompressor, char* destino, size_t tamanho) {
+    if (descompressor->terminou || descompressor->erro) return 0;
+
+    if (descompressor->membro.tipo == COMPACTACAO_ARMAZENADO) {
+        if ((long long)tamanho > descompressor->restante) tamanho = (size_t)descompressor->restante;
+        ssize_t lidos = (tamanho > 0) ? pread(descompressor->descritor, destino, tamanho, descompressor->posicao) : 0;
+        if (lidos <= 0) {
+            descompressor->terminou = 1;
+            descompressor->erro = descompressor->restante > 0;
+            return 0;
+        }
+        descompressor->posicao += lidos;
+        descompressor->restante -= lidos;
+        return (size_t)lidos;
+    }
+
+    z_stream* fluxo = &descompressor->fluxo;
+    fluxo->next_out = (Bytef*)destino;
+    fluxo->avail_out = (uInt)tamanho;
+    while (fluxo->avail_out > 0) {
+        if (fluxo->avail_in == 0 && descompressor->restante > 0) {
+            size_t pedir = (descompressor->restante < TAMANHO_ENTRADA_COMPACTADA) ? (size_t)descompressor->restante : TAMANHO_ENTRADA_COMPACTADA;
+            ssize_t lidos = pread(descompressor->descritor, descompressor->entrada, pedir, descompressor->posicao);
+            if (lidos <= 0) {
+                descompressor->erro = 1;
+                break;
+            }
+            descompressor->posicao += lidos;
+            descompressor->restante -= lidos;
+            fluxo->next_in = descompressor->entrada;
+            fluxo->avail_in = (uInt)lidos;
+        }
+
+        int estado = inflate(fluxo, Z_NO_FLUSH);
+        if (estado == Z_STREAM_END) {
+            // Um .gz pode ter vários membros gzip seguidos; no zip o membro acaba aqui.
+            if (descompressor->membro.tipo == COMPACTACAO_GZIP && (fluxo->avail_in > 0 || descompressor->restante > 0)) {
+                inflateReset(fluxo);
+                continue;
+            }
+            descompressor->terminou = 1;
+            break;
+        }
+        if (estado == Z_BUF_ERROR && fluxo->avail_in == 0 && descompressor->restante == 0) {
+            descompressor->erro = 1; // acabou a entrada antes do fim do fluxo
+            break;
+        }
+        if (estado != Z_OK && estado != Z_BUF_ERROR) {
+            descompressor->erro = 1;
+            break;
+        }
+    }
+    return tamanho - fluxo->avail_out;
+}
@@ -0,0 +1,51 @@
+#ifndef COMPACTADO_ENADE_H
+#define COMPACTADO_ENADE_H
+
+#include <sys/types.h>
+#include <zlib.h>
+
+// Leitura direta dos microdados compactados, sem descompactar em disco: membros do .zip distribuído
+// pelo INEP (armazenados ou deflate, inclusive zip64) e arquivos .gz (um ou mais membros gzip seguidos).
+// O conteúdo é descompactado em fluxo, na ordem, então cada membro é lido inteiro por uma só thread.
+
+#define TAMANHO_MAX_NOME_MEMBRO 256
+
+typedef enum {
+    COMPACTACAO_ARMAZENADO, // membro do zip sem compressão
+    COMPACTACAO_DEFLATE,    // membro do zip em deflate puro
+    COMPACTACAO_GZIP
+} TipoCompactacao;
+
+typedef struct {
+    char nome[TAMANHO_MAX_NOME_MEMBRO];
+    TipoCompactacao tipo;
+    off_t offset_dados;          // primeiro byte compactado dentro do arquivo
+    long long tamanho_compactado;
+    long long tamanho_original;  // -1 se desconhecido (.gz)
+} MembroCompactado;
+
+// Procura no .zip aberto em 'descritor' o membro cujo nome termina em 'nome_base' (ignorando as pastas
+// do zip). Retorna 0 se não achar, se o zip estiver corrompido ou se o membro for criptografado.
+int zip_encontrar_membro(int descritor, const char* nome_base, MembroCompactado* membro);
+// Descreve um .gz aberto em 'descritor' como um membro único. Retorna 0 se não for gzip.
+int gz_membro(int descritor, MembroCompactado* membro);
+
+typedef struct {
+    int descritor;
+    MembroCompactado membro;
+    z_stream fluxo;
+    int fluxo_iniciado;
+    unsigned char* entrada;
+    off_t posicao;               // próximo byte compactado a ser lido
+    long long restante;          // bytes compactados ainda não lidos
+    int terminou;
+    int erro;                    // dados corrompidos ou truncados
+} Descompressor;
+
+// Retorna 0 se faltar memória.
+int descompressor_iniciar(Descompressor* descompressor, int descritor, const MembroCompactado* membro);
+void descompressor_liberar(Descompressor* descompressor);
+// Descompacta até 'tamanho' bytes em 'destino'. Retorna quantos foram escritos; 0 no fim ou em erro.
+size_t descompressor_ler(Descompressor* descompressor, char* destino, size_t tamanho);
+
+#endif
@@ -0,0 +1,379 @@
+#include "cruzamento_enade.h"
+
+#include <mpi.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache_enade.h"
+#include "leitor_enade.h"
+#include "metricas_enade.h"
+#include "perguntas_enade.h"
+
+// Além das células, o vetor reduzido leva os totais no fim (os pares de ADS e, por arquivo, as linhas de ADS
+// sem par), para que tudo vá num único MPI_Reduce.
+#define TOTAL_LINHAS_ADS 0
+#define TOTAL_SEM_PAR 1
+#define NUM_TOTAIS (1 + MAX_DIMENSOES_CRUZAMENTO)
+
+static void falha_de_memoria(void) {
+    fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+    MPI_Abort(MPI_COMM_WORLD, 1);
+}
+
+int cruzamento_ler_especificacao(const char* texto, EspecificacaoCruzamento* especificacao) {
+    memset(especificacao, 0, sizeof(*especificacao));
+    while (*texto) {
+        const char* virgula = strchr(texto, ',');
+        size_t tamanho = virgula ? (size_t)(virgula - texto) : strlen(texto);
+        if (tamanho == 0 || tamanho >= TAMANHO_MAX_CAMINHO || especificacao->num_dimensoes == MAX_DIMENSOES_CRUZAMENTO) return 0;
+
+        char item[TAMANHO_MAX_CAMINHO];
+        memcpy(item, texto, tamanho);
+        item[tamanho] = '\0';
+
+        char* destino = especificacao->arquivos[especificacao->num_dimensoes++];
+        if (strchr(item, '/') || strchr(item, '.')) { // caminho completo
+            strcpy(destino, item);
+        } else {
+            const char* numero = (strncmp(item, "arq", 3) == 0) ? item + 3 : item;
+            char* fim_numero;
+            long arquivo = strtol(numero, &fim_numero, 10);
+            if (fim_numero == numero || *fim_numero != '\0' || arquivo < 1) return 0;
+            snprintf(destino, TAMANHO_MAX_CAMINHO, "DADOS/microdados2021_arq%ld.txt", arquivo);
+        }
+        texto += tamanho + (virgula ? 1 : 0);
+    }
+    return especificacao->num_dimensoes >= 2;
+}
+
+void cruzamento_nome_curto(const char* arquivo, char* destino, size_t tamanho) {
+    const char* inicio = strrchr(arquivo, '/');
+    inicio = inicio ? inicio + 1 : arquivo;
+    if (strncmp(inicio, "microdados2021_", 15) == 0) inicio += 15;
+    const char* ponto = strrchr(inicio, '.');
+    size_t comprimento = ponto ? (size_t)(ponto - inicio) : strlen(inicio);
+    snprintf(destino, tamanho, "%.*s", (int)comprimento, inicio);
+}
+
+void cruzamento_rotulo(const char* arquivo, int categoria, char* destino, size_t tamanho) {
+    if (categoria == CATEGORIA_NULAS) {
+        snprintf(destino, tamanho, "resposta vazia ou fora de A-Z"); // o que cruzamento_categoria não mapeia numa letra
+        return;
+    }
+    char letra = (char)('A' + categoria);
+    for (int p = 0; p < NUM_PERGUNTAS; p++) {
+        const Pergunta* pergunta = &PERGUNTAS[p];
+        const char* posicao = strchr(pergunta->letras, letra);
+        if (pergunta->tipo != PERGUNTA_DISTRIBUICAO || strcmp(pergunta->arquivo, arquivo) != 0 || !posicao) continue;
+
+        // Os rótulos do registro vêm com ':' e espaços de alinhamento no fim.
+        const char* rotulo = pergunta->rotulos[posicao - pergunta->letras];
+        size_t comprimento = strlen(rotulo);
+        while (comprimento > 0 && (rotulo[comprimento - 1] == ' ' || rotulo[comprimento - 1] == ':')) comprimento--;
+        snprintf(destino, tamanho, "%.*s", (int)comprimento, rotulo);
+        return;
+    }
+    snprintf(destino, tamanho, "%c", letra);
+}
+
+// Linha de ADS de um arquivo: CO_CURSO e resposta num só inteiro, para irem juntos no MPI_Alltoallv.
+static inline long long empacotar_linha(int codigo_curso, unsigned char resposta) {
+    return (long long)codigo_curso * 256 + resposta;
+}
+
+static inline int codigo_da_linha(long long linha) {
+    return (int)((linha - (linha & 0xFF)) / 256); // exato também para códigos negativos
+}
+
+typedef struct {
+    long long* itens;
+    long long quantidade;
+    long long capacidade;
+} ListaDeLinhas;
+
+static void lista_adicionar(ListaDeLinhas* lista, long long valor) {
+    if (lista->quantidade == lista->capacidade) {
+        lista->capacidade = lista->capacidade ? lista->capacidade * 2 : 4096;
+        long long* ponteiro_temp = realloc(lista->itens, sizeof(long long) * (size_t)lista->capacidade);
+        if (!ponteiro_temp) falha_de_memoria();
+        lista->itens = ponteiro_temp;
+    }
+    lista->itens[lista->quantidade++] = valor;
+}
+
+// Processo responsável por juntar as linhas de um CO_CURSO: todas as linhas do curso, de todos os arquivos, vão para ele.
+static inline int dono_do_curso(long long linha, int num_processos) {
+    return (int)((unsigned)codigo_da_linha(linha) % (unsigned)num_processos);
+}
+
+// Cache: as linhas são endereçáveis, então o processo fica com uma fatia contígua de linhas do arquivo.
+// O acesso ao mmap entra na contagem, como na análise principal.
+static void coletar_do_cache(const CacheColunar* cache, const IndiceCursos* cursos_ads, int rank_processo, int num_processos,
+                             ListaDeLinhas* lista, MetricasArquivo* metricas) {
+    long long num_linhas = (long long)cache->num_linhas;
+    long long inicio = num_linhas * rank_processo / num_processos;
+    long long fim = num_linhas * (rank_processo + 1) / num_processos;
+    double inicio_contagem = metricas_agora();
+    for (long long i = inicio; i < fim; i++) {
+        if (indice_cursos_contem(cursos_ads, cache->codigos_curso[i])) lista_adicionar(lista, empacotar_linha(cache->codigos_curso[i], cache->respostas[i]));
+    }
+    metricas->contagem += metricas_agora() - inicio_contagem;
+    metricas->linhas += (double)(fim - inicio);
+    metricas->bytes += (double)(fim - inicio) * (sizeof(int32_t) + sizeof(uint8_t));
+}
+
+// Texto: o processo lê só a sua fatia de bytes, com a mesma regra de posse das fatias da análise principal
+// (fica com as linhas que começam em [inicio, fim)).
+static void coletar_do_texto(int descritor, long long tamanho, const IndiceCursos* cursos_ads, ModoParser modo_parser, int rank_processo,
+                             int num_processos, ListaDeLinhas* lista, MetricasArquivo* metricas) {
+    off_t inicio = (off_t)(tamanho * rank_processo / num_processos);
+    off_t fim = (off_t)(tamanho * (rank_processo + 1) / num_processos);
+    if (inicio >= fim) return;
+
+    double inicio_parse = metricas_agora();
+    CursorDeLinhas cursor;
+    if (!cursor_abrir(&cursor, descritor, inicio, fim)) falha_de_memoria();
+    long long linhas = 0;
+    RegistroDados registro;
+    while (cursor_tem_linha(&cursor) && cursor_offset(&cursor) < fim && cursor_ler_registro(&cursor, modo_parser, &registro)) {
+        if (indice_cursos_contem(cursos_ads, registro.codigo_curso)) lista_adicionar(lista, empacotar_linha(registro.codigo_curso, (unsigned char)registro.resposta));
+        linhas++;
+    }
+    if (cursor.leitor.erro) falha_de_memoria();
+    metricas->leitura += cursor.leitor.tempo_leitura;
+    metricas->parse += metricas_agora() - inicio_parse - cursor.leitor.tempo_leitura;
+    metricas->bytes += (double)cursor.leitor.bytes_lidos;
+    metricas->linhas += (double)linhas;
+    cursor_fechar(&cursor);
+}
+
+typedef struct {
+    int codigo_curso;
+    unsigned char resposta;
+    long long ordem; // posição no arquivo, para que a ordenação por curso mantenha a ordem das linhas
+} LinhaDoCurso;
+
+static int comparar_linhas(const void* a, const void* b) {
+    const LinhaDoCurso* x = a;
+    const LinhaDoCurso* y = b;
+    if (x->codigo_curso != y->codigo_curso) return (x->codigo_curso > y->codigo_curso) - (x->codigo_curso < y->codigo_curso);
+    return (x->ordem > y->ordem) - (x->ordem < y->ordem);
+}
+
+// Junta os arquivos pelos cursos deste processo: dentro de cada CO_CURSO, a k-ésima linha de um arquivo forma par com a
+// k-ésima linha do mesmo curso nos demais. Um curso com linhas a mais num arquivo (ou ausente de algum) só perde as
+// linhas sem par, contadas por arquivo; os outros cursos não são afetados.
+static void juntar_por_curso(LinhaDoCurso** linhas, const long long* quantidades, int num_dimensoes, long long* contadores, long long num_celulas) {
+    long long posicoes[MAX_DIMENSOES_CRUZAMENTO] = {0}, fins[MAX_DIMENSOES_CRUZAMENTO];
+    long long* sem_par = contadores + num_celulas + TOTAL_SEM_PAR;
+    for (;;) {
+        int codigo_alvo = 0, acabou = 0;
+        for (int d = 0; d < num_dimensoes; d++) {
+            if (posicoes[d] == quantidades[d]) acabou = 1;
+            else if (d == 0 || linhas[d][posicoes[d]].codigo_curso > codigo_alvo) codigo_alvo = linhas[d][posicoes[d]].codigo_curso;
+        }
+        if (acabou) break;
+
+        // Avança até o próximo CO_CURSO presente em todos os arquivos.
+        int todos_no_alvo = 1;
+        for (int d = 0; d < num_dimensoes; d++) {
+            while (posicoes[d] < quantidades[d] && linhas[d][posicoes[d]].codigo_curso < codigo_alvo) {
+                sem_par[d]++;
+                posicoes[d]++;
+            }
+            if (posicoes[d] == quantidades[d] || linhas[d][posicoes[d]].codigo_curso != codigo_alvo) todos_no_alvo = 0;
+        }
+        if (!todos_no_alvo) continue;
+
+        long long pares = -1;
+        for (int d = 0; d < num_dimensoes; d++) {
+            for (fins[d] = posicoes[d]; fins[d] < quantidades[d] && linhas[d][fins[d]].codigo_curso == codigo_alvo; fins[d]++) {}
+            if (pares < 0 || fins[d] - posicoes[d] < pares) pares = fins[d] - posicoes[d];
+        }
+        for (long long k = 0; k < pares; k++) {
+            long long celula = 0;
+            for (int d = 0; d < num_dimensoes; d++) celula = celula * NUM_CATEGORIAS_CRUZAMENTO + cruzamento_categoria(linhas[d][posicoes[d] + k].resposta);
+            contadores[celula]++;
+        }
+        contadores[num_celulas + TOTAL_LINHAS_ADS] += pares;
+        for (int d = 0; d < num_dimensoes; d++) {
+            sem_par[d] += fins[d] - posicoes[d] - pares;
+            posicoes[d] = fins[d];
+        }
+    }
+    for (int d = 0; d < num_dimensoes; d++) sem_par[d] += quantidades[d] - posicoes[d];
+}
+
+// Leva cada linha de ADS ao dono do seu curso com um único MPI_Alltoallv. O bloco enviado a cada processo traz as
+// linhas do arquivo 0, depois as do arquivo 1 etc., na ordem do arquivo; como as fatias seguem a ordem dos processos,
+// o dono recebe as linhas de cada curso na ordem em que aparecem no arquivo.
+static void distribuir_e_juntar(ListaDeLinhas* locais, int num_dimensoes, int num_processos, long long* contadores, long long num_celulas,
+                                MetricasProcesso* metricas) {
+    int* envio = calloc((size_t)num_processos * num_dimensoes, sizeof(int));
+    int* recebimento = malloc(sizeof(int) * (size_t)num_processos * num_dimensoes);
+    int* contagens_envio = calloc((size_t)num_processos, sizeof(int));
+    int* contagens_recebimento = calloc((size_t)num_processos, sizeof(int));
+    int* deslocamentos_envio = malloc(sizeof(int) * (size_t)num_processos);
+    int* deslocamentos_recebimento = malloc(sizeof(int) * (size_t)num_processos);
+    long long* posicao_envio = malloc(sizeof(long long) * (size_t)num_processos * num_dimensoes);
+    if (!envio || !recebimento || !contagens_envio || !contagens_recebimento || !deslocamentos_envio || !deslocamentos_recebimento || !posicao_envio) {
+        falha_de_memoria();
+    }
+
+    long long total_envio = 0;
+    for (int d = 0; d < num_dimensoes; d++) {
+        for (long long i = 0; i < locais[d].quantidade; i++) envio[dono_do_curso(locais[d].itens[i], num_processos) * num_dimensoes + d]++;
+        total_envio += locais[d].quantidade;
+    }
+    long long deslocamento = 0;
+    for (int p = 0; p < num_processos; p++) {
+        deslocamentos_envio[p] = (int)deslocamento;
+        for (int d = 0; d < num_dimensoes; d++) {
+            posicao_envio[p * num_dimensoes + d] = deslocamento;
+            deslocamento += envio[p * num_dimensoes + d];
+            contagens_envio[p] += envio[p * num_dimensoes + d];
+        }
+    }
+    long long* buffer_envio = malloc(sizeof(long long) * (size_t)(total_envio ? total_envio : 1));
+    if (!buffer_envio) falha_de_memoria();
+    for (int d = 0; d < num_dimensoes; d++) {
+        for (long long i = 0; i < locais[d].quantidade; i++) {
+            int dono = dono_do_curso(locais[d].itens[i], num_processos);
+            buffer_envio[posicao_envio[dono * num_dimensoes + d]++] = locais[d].itens[i];
+        }
+        free(locais[d].itens);
+        locais[d].itens = NULL;
+    }
+
+    double inicio_coletiva = MPI_Wtime();
+    MPI_Alltoall(envio, num_dimensoes, MPI_INT, recebimento, num_dimensoes, MPI_INT, MPI_COMM_WORLD);
+    long long total_recebimento = 0;
+    for (int p = 0; p < num_processos; p++) {
+        deslocamentos_recebimento[p] = (int)total_recebimento;
+        for (int d = 0; d < num_dimensoes; d++) contagens_recebimento[p] += recebimento[p * num_dimensoes + d];
+        total_recebimento += contagens_recebimento[p];
+    }
+    long long* buffer_recebimento = malloc(sizeof(long long) * (size_t)(total_recebimento ? total_recebimento : 1));
+    if (!buffer_recebimento) falha_de_memoria();
+    MPI_Alltoallv(buffer_envio, contagens_envio, deslocamentos_envio, MPI_LONG_LONG,
+                  buffer_recebimento, contagens_recebimento, deslocamentos_recebimento, MPI_LONG_LONG, MPI_COMM_WORLD);
+    metricas->coletivas += MPI_Wtime() - inicio_coletiva;
+    free(buffer_envio);
+
+    // Separa o que chegou por arquivo, mantendo a ordem, e ordena por curso.
+    double inicio_juncao = metricas_agora();
+    LinhaDoCurso* linhas[MAX_DIMENSOES_CRUZAMENTO];
+    long long quantidades[MAX_DIMENSOES_CRUZAMENTO] = {0};
+    for (int d = 0; d < num_dimensoes; d++) {
+        long long total = 0;
+        for (int p = 0; p < num_processos; p++) total += recebimento[p * num_dimensoes + d];
+        linhas[d] = malloc(sizeof(LinhaDoCurso) * (size_t)(total ? total : 1));
+        if (!linhas[d]) falha_de_memoria();
+    }
+    for (int p = 0; p < num_processos; p++) {
+        const long long* bloco = buffer_recebimento + deslocamentos_recebimento[p];
+        for (int d = 0; d < num_dimensoes; d++) {
+            for (int i = 0; i < recebimento[p * num_dimensoes + d]; i++, bloco++) {
+                LinhaDoCurso* linha = &linhas[d][quantidades[d]];
+                linha->codigo_curso = codigo_da_linha(*bloco);
+                linha->resposta = (unsigned char)(*bloco & 0xFF);
+                linha->ordem = quantidades[d]++;
+            }
+        }
+    }
+    free(buffer_recebimento);
+    for (int d = 0; d < num_dimensoes; d++) qsort(linhas[d], (size_t)quantidades[d], sizeof(LinhaDoCurso), comparar_linhas);
+    juntar_por_curso(linhas, quantidades, num_dimensoes, contadores, num_celulas);
+    double juncao = metricas_agora() - inicio_juncao;
+    for (int d = 0; d < num_dimensoes; d++) {
+        metricas->arquivos[d].contagem += juncao / num_dimensoes;
+        free(linhas[d]);
+    }
+
+    free(envio);
+    free(recebimento);
+    free(contagens_envio);
+    free(contagens_recebimento);
+    free(deslocamentos_envio);
+    free(deslocamentos_recebimento);
+    free(posicao_envio);
+}
+
+int cruzamento_calcular(const EspecificacaoCruzamento* especificacao, const IndiceCursos* cursos_ads, ModoParser modo_parser,
+                        int usar_cache, int rank_processo, int num_processos, TabelaCruzada* tabela, MetricasProcesso* metricas) {
+    memset(tabela, 0, sizeof(*tabela));
+    int num_dimensoes = especificacao->num_dimensoes;
+    tabela->num_dimensoes = num_dimensoes;
+    tabela->num_celulas = 1;
+    for (int d = 0; d < num_dimensoes; d++) tabela->num_celulas *= NUM_CATEGORIAS_CRUZAMENTO;
+
+    // Fonte de cada arquivo, igual em todos os processos (senão as fatias de linhas e de bytes se misturariam):
+    // 2 = cache colunar, 1 = texto, 0 = não abre. O MPI_MIN escolhe o texto se algum processo não tiver o cache.
+    int descritores[MAX_DIMENSOES_CRUZAMENTO];
+    long long tamanhos[MAX_DIMENSOES_CRUZAMENTO];
+    CacheColunar caches[MAX_DIMENSOES_CRUZAMENTO];
+    int fontes_locais[MAX_DIMENSOES_CRUZAMENTO], fontes[MAX_DIMENSOES_CRUZAMENTO];
+    for (int d = 0; d < num_dimensoes; d++) {
+        struct stat info;
+        descritores[d] = open(especificacao->arquivos[d], O_RDONLY);
+        tamanhos[d] = (descritores[d] >= 0 && fstat(descritores[d], &info) == 0) ? (long long)info.st_size : -1;
+        int cache_ok = usar_cache && cache_abrir(especificacao->arquivos[d], &caches[d]) == CACHE_OK;
+        if (!cache_ok) memset(&caches[d], 0, sizeof(caches[d]));
+        fontes_locais[d] = (tamanhos[d] < 0) ? 0 : 1 + cache_ok;
+    }
+    double inicio_coletiva = MPI_Wtime();
+    MPI_Allreduce(fontes_locais, fontes, num_dimensoes, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    metricas->coletivas += MPI_Wtime() - inicio_coletiva;
+    int ok = 1;
+    for (int d = 0; d < num_dimensoes; d++) if (fontes[d] == 0) ok = 0;
+
+    long long tamanho_vetor = tabela->num_celulas + NUM_TOTAIS;
+    long long* contadores = calloc((size_t)tamanho_vetor, sizeof(long long));
+    if (!contadores) falha_de_memoria();
+
+    if (ok) {
+        // Uma única passada: cada processo lê só a sua fatia de cada arquivo, independente das fatias dos outros arquivos.
+        ListaDeLinhas locais[MAX_DIMENSOES_CRUZAMENTO];
+        memset(locais, 0, sizeof(locais));
+        for (int d = 0; d < num_dimensoes; d++) {
+            if (fontes[d] == 2) coletar_do_cache(&caches[d], cursos_ads, rank_processo, num_processos, &locais[d], &metricas->arquivos[d]);
+            else coletar_do_texto(descritores[d], tamanhos[d], cursos_ads, modo_parser, rank_processo, num_processos, &locais[d], &metricas->arquivos[d]);
+        }
+        distribuir_e_juntar(locais, num_dimensoes, num_processos, contadores, tabela->num_celulas, metricas);
+        metricas->chunks++;
+
+        // Mesma barreira da análise principal, para separar a espera pelo processo mais lento da redução.
+        double inicio_espera = MPI_Wtime();
+        MPI_Barrier(MPI_COMM_WORLD);
+        metricas->espera += MPI_Wtime() - inicio_espera;
+
+        if (rank_processo == 0) {
+            tabela->celulas = malloc(sizeof(long long) * (size_t)tamanho_vetor);
+            if (!tabela->celulas) falha_de_memoria();
+        }
+        double inicio_reducao = MPI_Wtime();
+        MPI_Reduce(contadores, tabela->celulas, (int)tamanho_vetor, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        metricas->coletivas += MPI_Wtime() - inicio_reducao;
+        if (rank_processo == 0) {
+            tabela->linhas_ads = tabela->celulas[tabela->num_celulas + TOTAL_LINHAS_ADS];
+            for (int d = 0; d < num_dimensoes; d++) tabela->linhas_sem_par[d] = tabela->celulas[tabela->num_celulas + TOTAL_SEM_PAR + d];
+        }
+    }
+
+    free(contadores);
+    for (int d = 0; d < num_dimensoes; d++) {
+        cache_fechar(&caches[d]);
+        if (descritores[d] >= 0) close(descritores[d]);
+    }
+    return ok;
+}
+
+void cruzamento_liberar(TabelaCruzada* tabela) {
+    free(tabela->celulas);
+    tabela->celulas = NULL;
+}
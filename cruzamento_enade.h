@@ -0,0 +1,54 @@
+#ifndef CRUZAMENTO_ENADE_H
+#define CRUZAMENTO_ENADE_H
+
+#include <stddef.h>
+
+#include "indice_cursos.h"
+#include "metricas_enade.h"
+#include "parser_enade.h"
+
+// Tabela de contingência entre as respostas de dois ou mais arquivos de dados (ex.: arq5 x arq29, sexo x horas de estudo).
+// Os arquivos trazem um estudante por linha, na mesma ordem e agrupados por curso. O cruzamento alinha as linhas dentro
+// de cada CO_CURSO: a k-ésima linha de um curso num arquivo é o mesmo estudante que a k-ésima linha do curso nos demais.
+// Assim uma linha a mais ou a menos num arquivo só desalinha o próprio curso; as linhas que ficam sem par são contadas
+// à parte, por arquivo.
+
+#define MAX_DIMENSOES_CRUZAMENTO 4
+#define NUM_CATEGORIAS_CRUZAMENTO 27 // letras 'A'..'Z' e uma categoria para as nulas/inválidas
+#define CATEGORIA_NULAS 26
+#define TAMANHO_MAX_CAMINHO 256
+
+typedef struct {
+    int num_dimensoes;
+    char arquivos[MAX_DIMENSOES_CRUZAMENTO][TAMANHO_MAX_CAMINHO];
+} EspecificacaoCruzamento;
+
+typedef struct {
+    int num_dimensoes;
+    long long num_celulas;          // NUM_CATEGORIAS_CRUZAMENTO ^ num_dimensoes
+    long long* celulas;             // a primeira dimensão varia mais devagar
+    long long linhas_ads;           // estudantes de ADS contados na tabela (linhas com par em todos os arquivos)
+    long long linhas_sem_par[MAX_DIMENSOES_CRUZAMENTO]; // linhas de ADS de cada arquivo sem a linha correspondente nos outros
+} TabelaCruzada;
+
+static inline int cruzamento_categoria(unsigned char resposta) {
+    return (resposta >= 'A' && resposta <= 'Z') ? resposta - 'A' : CATEGORIA_NULAS;
+}
+
+// Lê "arq5,arq29" (ou "5,29", ou caminhos completos). Retorna 0 se a lista for inválida.
+int cruzamento_ler_especificacao(const char* texto, EspecificacaoCruzamento* especificacao);
+// Nome curto do arquivo para os relatórios ("DADOS/microdados2021_arq29.txt" -> "arq29").
+void cruzamento_nome_curto(const char* arquivo, char* destino, size_t tamanho);
+// Rótulo de uma categoria: o rótulo do registro de perguntas quando houver, senão a própria letra. Para
+// CATEGORIA_NULAS, descreve os valores brutos que caem nela.
+void cruzamento_rotulo(const char* arquivo, int categoria, char* destino, size_t tamanho);
+
+// Monta a tabela em paralelo entre os processos numa única passada e junta tudo com um único MPI_Reduce no rank 0.
+// É coletiva. Cada arquivo é lido do cache colunar quando todos os processos tiverem um cache válido dele, senão do texto.
+// Retorna 0 (em todos os processos) se algum arquivo não puder ser aberto.
+// Soma em 'metricas' as coletivas, a espera e as fases de cada arquivo (na ordem da especificação).
+int cruzamento_calcular(const EspecificacaoCruzamento* especificacao, const IndiceCursos* cursos_ads, ModoParser modo_parser,
+                        int usar_cache, int rank_processo, int num_processos, TabelaCruzada* tabela, MetricasProcesso* metricas);
+void cruzamento_liberar(TabelaCruzada* tabela);
+
+#endif
@@ -0,0 +1,77 @@
+#include "exportacao_enade.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "perguntas_enade.h"
+
+// Nome da resposta de um contador da pergunta: a letra, "outras" para o último contador
+// ou "todas" quando a pergunta só conta as linhas.
+static void nome_da_resposta(const Pergunta* pergunta, int posicao, char* destino) {
+    int num_letras = (int)strlen(pergunta->letras);
+    if (posicao < num_letras) {
+        destino[0] = pergunta->letras[posicao];
+        destino[1] = '\0';
+    } else {
+        strcpy(destino, num_letras == 0 ? "todas" : "outras");
+    }
+}
+
+static void escrever_texto_json(FILE* saida, const char* texto) {
+    fputc('"', saida);
+    for (; *texto; texto++) {
+        if (*texto == '"' || *texto == '\\') fputc('\\', saida);
+        fputc(*texto, saida);
+    }
+    fputc('"', saida);
+}
+
+int exportar_csv(const char* caminho, const ContagensPorGrupo* contagens) {
+    FILE* saida = fopen(caminho, "w");
+    if (!saida) return 0;
+
+    int num_contadores = perguntas_num_contadores();
+    char resposta[8];
+    fprintf(saida, "co_grupo,cursos,pergunta,resposta,estudantes\n");
+    for (int g = 0; g < contagens->num_grupos; g++) {
+        const long long* contadores = contagens->contadores + (size_t)g * num_contadores;
+        for (int p = 0; p < NUM_PERGUNTAS; p++) {
+            int primeiro = perguntas_primeiro_contador(p);
+            for (int i = primeiro; i <= perguntas_contador_outras(p); i++) {
+                nome_da_resposta(&PERGUNTAS[p], i - primeiro, resposta);
+                fprintf(saida, "%d,%d,%d,\"%s\",%lld\n", contagens->codigos_grupo[g], contagens->cursos_por_grupo[g], p + 1, resposta, contadores[i]);
+            }
+        }
+    }
+    return fclose(saida) == 0;
+}
+
+int exportar_json(const char* caminho, const ContagensPorGrupo* contagens) {
+    FILE* saida = fopen(caminho, "w");
+    if (!saida) return 0;
+
+    int num_contadores = perguntas_num_contadores();
+    char resposta[8];
+    fprintf(saida, "{\n  \"grupos\": [");
+    for (int g = 0; g < contagens->num_grupos; g++) {
+        const long long* contadores = contagens->contadores + (size_t)g * num_contadores;
+        fprintf(saida, "%s\n    {\"co_grupo\": %d, \"cursos\": %d, \"perguntas\": [", g == 0 ? "" : ",",
+                contagens->codigos_grupo[g], contagens->cursos_por_grupo[g]);
+        for (int p = 0; p < NUM_PERGUNTAS; p++) {
+            fprintf(saida, "%s\n      {\"pergunta\": %d, \"enunciado\": ", p == 0 ? "" : ",", p + 1);
+            escrever_texto_json(saida, PERGUNTAS[p].enunciado);
+            fprintf(saida, ", \"respostas\": {");
+            int primeiro = perguntas_primeiro_contador(p);
+            for (int i = primeiro; i <= perguntas_contador_outras(p); i++) {
+                nome_da_resposta(&PERGUNTAS[p], i - primeiro, resposta);
+                fprintf(saida, "%s", i == primeiro ? "" : ", ");
+                escrever_texto_json(saida, resposta);
+                fprintf(saida, ": %lld", contadores[i]);
+            }
+            fprintf(saida, "}}");
+        }
+        fprintf(saida, "\n    ]}");
+    }
+    fprintf(saida, "\n  ]\n}\n");
+    return fclose(saida) == 0;
+}
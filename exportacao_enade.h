@@ -0,0 +1,19 @@
+#ifndef EXPORTACAO_ENADE_H
+#define EXPORTACAO_ENADE_H
+
+// Exporta as contagens das perguntas (perguntas_enade.h) de um ou mais grupos de curso em CSV ou JSON,
+// para quem for tratar os resultados fora do programa.
+
+typedef struct {
+    int num_grupos;
+    const int* codigos_grupo;      // CO_GRUPO de cada bloco
+    const int* cursos_por_grupo;
+    const long long* contadores;   // num_grupos blocos de perguntas_num_contadores() contadores
+} ContagensPorGrupo;
+
+// Uma linha por contador: co_grupo,cursos,pergunta,resposta,estudantes. Retorna 0 se não conseguir gravar.
+int exportar_csv(const char* caminho, const ContagensPorGrupo* contagens);
+// Um objeto por grupo, com as respostas de cada pergunta. Retorna 0 se não conseguir gravar.
+int exportar_json(const char* caminho, const ContagensPorGrupo* contagens);
+
+#endif
@@ -0,0 +1,244 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+// Gerador de microdados sintéticos no formato do ENADE 2021, para medir o mpi_enade sem o download do INEP.
+// Escreve <destino>/microdados2021_arq1.txt e os arquivos de dados usados pelas perguntas, com os mesmos
+// cabeçalhos e o mesmo layout (campos separados por ';' e resposta entre aspas). A linha i de todos os
+// arquivos é o mesmo estudante e as linhas saem agrupadas por CO_CURSO, como nos arquivos reais.
+// Compilação: gcc -O2 -o gerador_enade gerador_enade.c
+
+#define ANO 2021
+#define CODIGO_GRUPO_ADS 72
+#define CODIGO_CURSO_MAXIMO 5000000 // ordem de grandeza dos CO_CURSO do e-MEC
+#define MAX_ALTERNATIVAS 8
+#define TAMANHO_BUFFER_SAIDA (1 << 20)
+
+typedef struct {
+    int numero;             // arqN
+    const char* coluna;
+    const char* letras;
+    double pesos[MAX_ALTERNATIVAS];
+} ArquivoGerado;
+
+// Arquivos lidos pelas perguntas do mpi_enade, com distribuições próximas das observadas em ADS.
+static ArquivoGerado ARQUIVOS[] = {
+    { 5,  "TP_SEXO", "FM",      { 15, 85 } },
+    { 21, "QE_I15",  "ABCDEF",  { 80, 8, 4, 3, 3, 2 } },
+    { 24, "QE_I18",  "ABCDE",   { 70, 20, 5, 3, 2 } },
+    { 25, "QE_I19",  "ABCDEFG", { 30, 10, 45, 3, 2, 4, 6 } },
+    { 27, "QE_I21",  "AB",      { 45, 55 } },
+    { 28, "QE_I22",  "ABCDE",   { 25, 40, 22, 7, 6 } },
+    { 29, "QE_I23",  "ABCDE",   { 8, 45, 30, 10, 7 } },
+};
+#define NUM_ARQUIVOS ((int)(sizeof(ARQUIVOS) / sizeof(ARQUIVOS[0])))
+
+// Outros CO_GRUPO que aparecem nos microdados, para os cursos que não são de ADS.
+static const int OUTROS_GRUPOS[] = { 1, 2, 13, 18, 22, 26, 29, 38, 67, 79, 81, 83, 84, 85, 86, 87, 88, 6306, 6407, 6410 };
+#define NUM_OUTROS_GRUPOS ((int)(sizeof(OUTROS_GRUPOS) / sizeof(OUTROS_GRUPOS[0])))
+
+typedef struct {
+    long long linhas;
+    double fracao_ads;   // fração das linhas em cursos de ADS
+    int cursos;          // cursos distintos
+    double fracao_nulas; // fração de respostas vazias
+    uint64_t semente;
+    const char* destino;
+} Parametros;
+
+typedef struct {
+    int codigo;
+    int grupo;
+    long long linhas;
+} Curso;
+
+// xorshift64*: rápido, reprodutível pela semente e sem depender da rand() da libc.
+static uint64_t estado_aleatorio;
+
+static uint64_t proximo_aleatorio(void) {
+    estado_aleatorio ^= estado_aleatorio >> 12;
+    estado_aleatorio ^= estado_aleatorio << 25;
+    estado_aleatorio ^= estado_aleatorio >> 27;
+    return estado_aleatorio * 2685821657736338717ull;
+}
+
+static double aleatorio_unitario(void) {
+    return (double)(proximo_aleatorio() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static long long aleatorio_ate(long long limite) {
+    return (long long)(proximo_aleatorio() % (uint64_t)limite);
+}
+
+static int comparar_cursos(const void* a, const void* b) {
+    return ((const Curso*)a)->codigo - ((const Curso*)b)->codigo;
+}
+
+// Sorteia uma alternativa segundo os pesos, ou 0 para resposta vazia.
+static char sortear_resposta(const ArquivoGerado* arquivo, double fracao_nulas) {
+    if (aleatorio_unitario() < fracao_nulas) return 0;
+    int num_letras = (int)strlen(arquivo->letras);
+    double total = 0;
+    for (int i = 0; i < num_letras; i++) total += arquivo->pesos[i];
+    double sorteio = aleatorio_unitario() * total;
+    for (int i = 0; i < num_letras; i++) {
+        sorteio -= arquivo->pesos[i];
+        if (sorteio < 0) return arquivo->letras[i];
+    }
+    return arquivo->letras[num_letras - 1];
+}
+
+// "--distribuicao=arq29:10,40,30,10,10": troca os pesos das alternativas de um arquivo.
+static int ler_distribuicao(const char* texto) {
+    int numero;
+    int lidos;
+    if (sscanf(texto, "arq%d:%n", &numero, &lidos) != 1) return 0;
+    for (int a = 0; a < NUM_ARQUIVOS; a++) {
+        if (ARQUIVOS[a].numero != numero) continue;
+        int num_letras = (int)strlen(ARQUIVOS[a].letras);
+        const char* peso = texto + lidos;
+        for (int i = 0; i < num_letras; i++) {
+            char* fim;
+            ARQUIVOS[a].pesos[i] = strtod(peso, &fim);
+            if (fim == peso || ARQUIVOS[a].pesos[i] < 0) return 0;
+            peso = (*fim == ',') ? fim + 1 : fim;
+        }
+        return *peso == '\0';
+    }
+    return 0;
+}
+
+static int ler_argumentos(int argc, char** argv, Parametros* parametros) {
+    parametros->linhas = 1000000;
+    parametros->fracao_ads = 0.03;
+    parametros->cursos = 8000;
+    parametros->fracao_nulas = 0.02;
+    parametros->semente = 2021;
+    parametros->destino = "DADOS";
+
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--linhas=", 9) == 0) {
+            parametros->linhas = atoll(argv[i] + 9);
+        } else if (strncmp(argv[i], "--fracao-ads=", 13) == 0) {
+            parametros->fracao_ads = atof(argv[i] + 13);
+        } else if (strncmp(argv[i], "--cursos=", 9) == 0) {
+            parametros->cursos = atoi(argv[i] + 9);
+        } else if (strncmp(argv[i], "--nulas=", 8) == 0) {
+            parametros->fracao_nulas = atof(argv[i] + 8);
+        } else if (strncmp(argv[i], "--semente=", 10) == 0) {
+            parametros->semente = strtoull(argv[i] + 10, NULL, 10);
+        } else if (strncmp(argv[i], "--destino=", 10) == 0) {
+            parametros->destino = argv[i] + 10;
+        } else if (strncmp(argv[i], "--distribuicao=", 15) == 0) {
+            if (!ler_distribuicao(argv[i] + 15)) return 0;
+        } else {
+            return 0;
+        }
+    }
+    return parametros->linhas >= 0 && parametros->cursos >= 2 && parametros->cursos <= CODIGO_CURSO_MAXIMO / 2 &&
+           parametros->fracao_ads >= 0 && parametros->fracao_ads <= 1 && parametros->fracao_nulas >= 0 && parametros->fracao_nulas <= 1;
+}
+
+static void imprimir_uso(const char* programa) {
+    fprintf(stderr, "Uso: %s [opções]\n", programa);
+    fprintf(stderr, "  --linhas=N                      estudantes (linhas de cada arquivo, padrão 1000000)\n");
+    fprintf(stderr, "  --fracao-ads=F                  fração das linhas em cursos de ADS (padrão 0.03)\n");
+    fprintf(stderr, "  --cursos=N                      cursos distintos (padrão 8000)\n");
+    fprintf(stderr, "  --nulas=F                       fração de respostas vazias (padrão 0.02)\n");
+    fprintf(stderr, "  --distribuicao=arqN:p1,p2,...   pesos das alternativas de um arquivo\n");
+    fprintf(stderr, "  --semente=S                     semente do gerador (padrão 2021)\n");
+    fprintf(stderr, "  --destino=DIR                   diretório de saída (padrão DADOS)\n");
+}
+
+static FILE* abrir_saida(const char* destino, int numero, char* buffer) {
+    char caminho[1024];
+    snprintf(caminho, sizeof(caminho), "%s/microdados%d_arq%d.txt", destino, ANO, numero);
+    FILE* saida = fopen(caminho, "w");
+    if (!saida) {
+        fprintf(stderr, "Erro fatal: não foi possível criar '%s'.\n", caminho);
+        exit(1);
+    }
+    setvbuf(saida, buffer, _IOFBF, TAMANHO_BUFFER_SAIDA);
+    return saida;
+}
+
+int main(int argc, char** argv) {
+    Parametros parametros;
+    if (!ler_argumentos(argc, argv, &parametros)) {
+        imprimir_uso(argv[0]);
+        return 1;
+    }
+    estado_aleatorio = parametros.semente * 0x9E3779B97F4A7C15ull + 1;
+    mkdir(parametros.destino, 0755);
+
+    // Cursos com códigos distintos; ~fracao_ads deles (pelo menos um) são de ADS.
+    Curso* cursos = calloc((size_t)parametros.cursos, sizeof(Curso));
+    char* usado = calloc(CODIGO_CURSO_MAXIMO + 1, 1);
+    char* buffers = malloc((size_t)(NUM_ARQUIVOS + 1) * TAMANHO_BUFFER_SAIDA);
+    if (!cursos || !usado || !buffers) {
+        fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+        return 1;
+    }
+    int cursos_ads = (int)(parametros.cursos * parametros.fracao_ads + 0.5);
+    if (cursos_ads < 1) cursos_ads = 1;
+    if (cursos_ads >= parametros.cursos) cursos_ads = parametros.cursos - 1;
+    for (int c = 0; c < parametros.cursos; c++) {
+        int codigo;
+        do { codigo = 1 + (int)aleatorio_ate(CODIGO_CURSO_MAXIMO); } while (usado[codigo]);
+        usado[codigo] = 1;
+        cursos[c].codigo = codigo;
+        cursos[c].grupo = (c < cursos_ads) ? CODIGO_GRUPO_ADS : OUTROS_GRUPOS[aleatorio_ate(NUM_OUTROS_GRUPOS)];
+    }
+    free(usado);
+
+    // Cada estudante cai num curso de ADS com probabilidade fracao_ads.
+    long long linhas_ads = 0;
+    for (long long i = 0; i < parametros.linhas; i++) {
+        if (aleatorio_unitario() < parametros.fracao_ads) {
+            cursos[aleatorio_ate(cursos_ads)].linhas++;
+            linhas_ads++;
+        } else {
+            cursos[cursos_ads + aleatorio_ate(parametros.cursos - cursos_ads)].linhas++;
+        }
+    }
+    qsort(cursos, (size_t)parametros.cursos, sizeof(Curso), comparar_cursos);
+
+    FILE* arq1 = abrir_saida(parametros.destino, 1, buffers);
+    FILE* saidas[NUM_ARQUIVOS];
+    fprintf(arq1, "NU_ANO;CO_CURSO;CO_IES;CO_CATEGAD;CO_ORGACAD;CO_GRUPO;CO_MODALIDADE;CO_MUNIC_CURSO;CO_UF_CURSO;CO_REGIAO_CURSO\n");
+    for (int a = 0; a < NUM_ARQUIVOS; a++) {
+        saidas[a] = abrir_saida(parametros.destino, ARQUIVOS[a].numero, buffers + (size_t)(a + 1) * TAMANHO_BUFFER_SAIDA);
+        fprintf(saidas[a], "NU_ANO;CO_CURSO;%s\n", ARQUIVOS[a].coluna);
+    }
+
+    for (int c = 0; c < parametros.cursos; c++) {
+        const Curso* curso = &cursos[c];
+        // Dados institucionais fixos por curso, derivados do código para não consumir a sequência aleatória.
+        int ies = 1 + curso->codigo % 25000;
+        int uf = 11 + curso->codigo % 43;
+        for (long long l = 0; l < curso->linhas; l++) {
+            fprintf(arq1, "%d;%d;%d;%d;%d;%d;%d;%d;%d;%d\n", ANO, curso->codigo, ies, 1 + ies % 5, 10019 + ies % 10 * 1000,
+                    curso->grupo, curso->codigo % 2, uf * 100000 + curso->codigo % 99999, uf, uf / 10);
+            for (int a = 0; a < NUM_ARQUIVOS; a++) {
+                char resposta = sortear_resposta(&ARQUIVOS[a], parametros.fracao_nulas);
+                if (resposta) fprintf(saidas[a], "%d;%d;\"%c\"\n", ANO, curso->codigo, resposta);
+                else fprintf(saidas[a], "%d;%d;\n", ANO, curso->codigo);
+            }
+        }
+    }
+
+    int erro = fclose(arq1) != 0;
+    for (int a = 0; a < NUM_ARQUIVOS; a++) erro |= fclose(saidas[a]) != 0;
+    if (erro) {
+        fprintf(stderr, "Erro fatal: falha ao gravar os arquivos em '%s'.\n", parametros.destino);
+        return 1;
+    }
+    printf("Gerados %lld estudantes em %d cursos (%d de ADS) em '%s/'.\n", parametros.linhas, parametros.cursos, cursos_ads, parametros.destino);
+    printf("Estudantes de ADS: %lld\n", linhas_ads);
+
+    free(cursos);
+    free(buffers);
+    return 0;
+}
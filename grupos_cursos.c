@@ -0,0 +1,137 @@
+#include "grupos_cursos.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void mapa_grupos_iniciar(MapaGrupos* mapa) {
+    memset(mapa, 0, sizeof(*mapa));
+    mapa->tipo = INDICE_HASH;
+}
+
+// Insere sem checar carga; a tabela precisa ter slot livre. Retorna 0 se o curso já estava na tabela.
+static int inserir_na_tabela(int32_t* chaves, uint16_t* blocos, size_t tamanho, int codigo_curso, uint16_t bloco) {
+    for (uint32_t i = indice_cursos_hash(codigo_curso, tamanho);; i = (i + 1) & (uint32_t)(tamanho - 1)) {
+        if (chaves[i] == codigo_curso) return 0;
+        if (chaves[i] == INDICE_SLOT_VAZIO) {
+            chaves[i] = codigo_curso;
+            blocos[i] = bloco;
+            return 1;
+        }
+    }
+}
+
+static int nova_tabela(size_t tamanho, int32_t** chaves, uint16_t** blocos) {
+    *chaves = malloc(tamanho * sizeof(int32_t));
+    *blocos = malloc(tamanho * sizeof(uint16_t));
+    if (!*chaves || !*blocos) {
+        free(*chaves);
+        free(*blocos);
+        return 0;
+    }
+    for (size_t i = 0; i < tamanho; i++) (*chaves)[i] = INDICE_SLOT_VAZIO;
+    return 1;
+}
+
+// Número de bloco do grupo, criando um novo se ele ainda não apareceu. Retorna -1 se há grupos demais.
+static int bloco_do_grupo(MapaGrupos* mapa, int codigo_grupo) {
+    for (int g = 0; g < mapa->num_grupos; g++) {
+        if (mapa->codigos_grupo[g] == codigo_grupo) return g;
+    }
+    if (mapa->num_grupos == MAX_GRUPOS) return -1;
+    mapa->codigos_grupo[mapa->num_grupos] = codigo_grupo;
+    mapa->cursos_por_grupo[mapa->num_grupos] = 0;
+    return mapa->num_grupos++;
+}
+
+int mapa_grupos_inserir(MapaGrupos* mapa, int codigo_curso, int codigo_grupo) {
+    if (codigo_curso == INDICE_SLOT_VAZIO) return 0; // nunca aparece como CO_CURSO
+
+    // Mantém a carga abaixo de 50% para a sondagem linear continuar curta.
+    if ((size_t)(mapa->quantidade + 1) * 2 > mapa->tamanho) {
+        size_t novo_tamanho = (mapa->tamanho == 0) ? 256 : mapa->tamanho * 2;
+        int32_t* chaves;
+        uint16_t* blocos;
+        if (!nova_tabela(novo_tamanho, &chaves, &blocos)) return -1;
+        for (size_t i = 0; i < mapa->tamanho; i++) {
+            if (mapa->chaves[i] != INDICE_SLOT_VAZIO) inserir_na_tabela(chaves, blocos, novo_tamanho, mapa->chaves[i], mapa->blocos[i]);
+        }
+        free(mapa->chaves);
+        free(mapa->blocos);
+        mapa->chaves = chaves;
+        mapa->blocos = blocos;
+        mapa->tamanho = novo_tamanho;
+    }
+
+    // O arq1 traz um estudante por linha: quase sempre o curso já está no mapa.
+    if (mapa_grupos_bloco(mapa, codigo_curso) >= 0) return 0;
+    int bloco = bloco_do_grupo(mapa, codigo_grupo);
+    if (bloco < 0) return -1;
+
+    inserir_na_tabela(mapa->chaves, mapa->blocos, mapa->tamanho, codigo_curso, (uint16_t)bloco);
+    mapa->cursos_por_grupo[bloco]++;
+    if (mapa->quantidade == 0 || codigo_curso > mapa->codigo_maximo) mapa->codigo_maximo = codigo_curso;
+    if (mapa->quantidade == 0 || codigo_curso < mapa->codigo_minimo) mapa->codigo_minimo = codigo_curso;
+    mapa->quantidade++;
+    return 1;
+}
+
+int mapa_grupos_finalizar(MapaGrupos* mapa) {
+    // Renumera os blocos na ordem crescente do CO_GRUPO, para os relatórios saírem ordenados.
+    int ordem[MAX_GRUPOS];
+    uint16_t novo_bloco[MAX_GRUPOS];
+    for (int g = 0; g < mapa->num_grupos; g++) ordem[g] = g;
+    for (int i = 1; i < mapa->num_grupos; i++) { // poucos grupos: inserção basta
+        int atual = ordem[i], j = i - 1;
+        while (j >= 0 && mapa->codigos_grupo[ordem[j]] > mapa->codigos_grupo[atual]) {
+            ordem[j + 1] = ordem[j];
+            j--;
+        }
+        ordem[j + 1] = atual;
+    }
+    int codigos_grupo[MAX_GRUPOS], cursos_por_grupo[MAX_GRUPOS];
+    for (int g = 0; g < mapa->num_grupos; g++) {
+        novo_bloco[ordem[g]] = (uint16_t)g;
+        codigos_grupo[g] = mapa->codigos_grupo[ordem[g]];
+        cursos_por_grupo[g] = mapa->cursos_por_grupo[ordem[g]];
+    }
+    memcpy(mapa->codigos_grupo, codigos_grupo, sizeof(int) * (size_t)mapa->num_grupos);
+    memcpy(mapa->cursos_por_grupo, cursos_por_grupo, sizeof(int) * (size_t)mapa->num_grupos);
+    for (size_t i = 0; i < mapa->tamanho; i++) {
+        if (mapa->chaves[i] != INDICE_SLOT_VAZIO) mapa->blocos[i] = novo_bloco[mapa->blocos[i]];
+    }
+
+    size_t posicoes = (size_t)(uint32_t)mapa->codigo_maximo + 1;
+    int cabe_no_vetor = mapa->quantidade > 0 && mapa->codigo_minimo >= 0 && posicoes * sizeof(uint16_t) <= MAPA_LIMITE_DENSO_BYTES;
+    if (!cabe_no_vetor) return 1;
+
+    uint16_t* denso = malloc(posicoes * sizeof(uint16_t));
+    if (!denso) return 0;
+    for (size_t c = 0; c < posicoes; c++) denso[c] = GRUPO_NENHUM;
+    for (size_t i = 0; i < mapa->tamanho; i++) {
+        if (mapa->chaves[i] != INDICE_SLOT_VAZIO) denso[(uint32_t)mapa->chaves[i]] = mapa->blocos[i];
+    }
+    free(mapa->chaves);
+    free(mapa->blocos);
+    mapa->chaves = NULL;
+    mapa->blocos = denso;
+    mapa->tamanho = posicoes;
+    mapa->tipo = INDICE_BITMAP;
+    return 1;
+}
+
+int mapa_grupos_listar(const MapaGrupos* mapa, int32_t* pares) {
+    int quantidade = 0;
+    for (size_t i = 0; i < mapa->tamanho; i++) {
+        if (mapa->chaves[i] == INDICE_SLOT_VAZIO) continue;
+        pares[2 * quantidade] = mapa->chaves[i];
+        pares[2 * quantidade + 1] = mapa->codigos_grupo[mapa->blocos[i]];
+        quantidade++;
+    }
+    return quantidade;
+}
+
+void mapa_grupos_liberar(MapaGrupos* mapa) {
+    free(mapa->blocos);
+    free(mapa->chaves);
+    mapa_grupos_iniciar(mapa);
+}
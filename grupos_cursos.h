@@ -0,0 +1,56 @@
+#ifndef GRUPOS_CURSOS_H
+#define GRUPOS_CURSOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "indice_cursos.h"
+
+// Mapa CO_CURSO -> grupo do curso (CO_GRUPO), para contar todos os grupos numa única passada.
+// Cada CO_GRUPO distinto recebe um número de bloco (0..num_grupos-1, na ordem crescente do CO_GRUPO),
+// que é o que o mapa guarda. Como o IndiceCursos, é montado numa tabela hash e, se os códigos de curso
+// forem densos o bastante, vira um vetor indexado pelo próprio código.
+
+#define MAX_GRUPOS 1024
+#define GRUPO_NENHUM UINT16_MAX
+#define MAPA_LIMITE_DENSO_BYTES (64u << 20) // acima disso (códigos > ~33 milhões) continua como hash
+
+typedef struct {
+    TipoIndice tipo;                   // INDICE_BITMAP (vetor denso) ou INDICE_HASH depois de finalizado
+    int quantidade;                    // cursos distintos
+    int codigo_maximo;
+    int codigo_minimo;
+    int num_grupos;
+    int codigos_grupo[MAX_GRUPOS];     // CO_GRUPO de cada bloco
+    int cursos_por_grupo[MAX_GRUPOS];
+    uint16_t* blocos;                  // vetor denso: bloco do curso c em blocos[c]; hash: valor de cada slot
+    int32_t* chaves;                   // hash: CO_CURSO de cada slot, INDICE_SLOT_VAZIO nos livres
+    size_t tamanho;                    // posições do vetor denso ou slots da tabela (potência de 2)
+} MapaGrupos;
+
+void mapa_grupos_iniciar(MapaGrupos* mapa);
+// Associa um curso ao seu grupo; um curso repetido mantém o primeiro grupo visto.
+// Retorna 1 se o curso é novo, 0 se já estava no mapa e -1 se faltou memória ou se há grupos demais.
+int mapa_grupos_inserir(MapaGrupos* mapa, int codigo_curso, int codigo_grupo);
+// Ordena os grupos e troca a representação de construção pela definitiva. Retorna 0 se faltou memória.
+int mapa_grupos_finalizar(MapaGrupos* mapa);
+// Copia os pares (CO_CURSO, CO_GRUPO) de um mapa ainda não finalizado para 'pares' (com espaço para
+// 2 * quantidade inteiros), para serem juntados com os de outros processos. Retorna quantos pares foram copiados.
+int mapa_grupos_listar(const MapaGrupos* mapa, int32_t* pares);
+void mapa_grupos_liberar(MapaGrupos* mapa);
+
+// Bloco do grupo do curso, ou -1 se o curso não estava no arq1.
+static inline int mapa_grupos_bloco(const MapaGrupos* mapa, int codigo_curso) {
+    if (mapa->tipo == INDICE_BITMAP) {
+        uint32_t c = (uint32_t)codigo_curso;
+        if (c >= (uint32_t)mapa->tamanho || mapa->blocos[c] == GRUPO_NENHUM) return -1;
+        return mapa->blocos[c];
+    }
+    if (mapa->tamanho == 0) return -1;
+    for (uint32_t i = indice_cursos_hash(codigo_curso, mapa->tamanho);; i = (i + 1) & (uint32_t)(mapa->tamanho - 1)) {
+        if (mapa->chaves[i] == codigo_curso) return mapa->blocos[i];
+        if (mapa->chaves[i] == INDICE_SLOT_VAZIO) return -1;
+    }
+}
+
+#endif
@@ -0,0 +1,102 @@
+#include "indice_cursos.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+void indice_cursos_iniciar(IndiceCursos* indice) {
+    memset(indice, 0, sizeof(*indice));
+    indice->tipo = INDICE_HASH;
+}
+
+// Insere sem checar carga nem atualizar estatísticas; a tabela precisa ter slot livre.
+static int inserir_na_tabela(int32_t* tabela, size_t tamanho, int codigo) {
+    for (uint32_t i = indice_cursos_hash(codigo, tamanho);; i = (i + 1) & (uint32_t)(tamanho - 1)) {
+        if (tabela[i] == codigo) return 0;
+        if (tabela[i] == INDICE_SLOT_VAZIO) {
+            tabela[i] = codigo;
+            return 1;
+        }
+    }
+}
+
+static int32_t* nova_tabela(size_t tamanho) {
+    int32_t* tabela = malloc(tamanho * sizeof(int32_t));
+    if (!tabela) return NULL;
+    for (size_t i = 0; i < tamanho; i++) tabela[i] = INDICE_SLOT_VAZIO;
+    return tabela;
+}
+
+int indice_cursos_inserir(IndiceCursos* indice, int codigo) {
+    if (codigo == INDICE_SLOT_VAZIO) return 0; // nunca aparece como CO_CURSO
+
+    // Mantém a carga abaixo de 50% para a sondagem linear continuar curta.
+    if ((size_t)(indice->quantidade + 1) * 2 > indice->tamanho) {
+        size_t novo_tamanho = (indice->tamanho == 0) ? 256 : indice->tamanho * 2;
+        int32_t* nova = nova_tabela(novo_tamanho);
+        if (!nova) return -1;
+        for (size_t i = 0; i < indice->tamanho; i++) {
+            if (indice->tabela[i] != INDICE_SLOT_VAZIO) inserir_na_tabela(nova, novo_tamanho, indice->tabela[i]);
+        }
+        free(indice->tabela);
+        indice->tabela = nova;
+        indice->tamanho = novo_tamanho;
+    }
+
+    if (!inserir_na_tabela(indice->tabela, indice->tamanho, codigo)) return 0;
+    if (indice->quantidade == 0 || codigo > indice->codigo_maximo) indice->codigo_maximo = codigo;
+    if (indice->quantidade == 0 || codigo < indice->codigo_minimo) indice->codigo_minimo = codigo;
+    indice->quantidade++;
+    return 1;
+}
+
+int indice_cursos_finalizar(IndiceCursos* indice, TipoIndice preferido) {
+    size_t palavras = (size_t)(uint32_t)indice->codigo_maximo / 64 + 1;
+    int cabe_no_bitmap = indice->codigo_minimo >= 0 && palavras * sizeof(uint64_t) <= INDICE_LIMITE_BITMAP_BYTES;
+
+    if (preferido == INDICE_HASH || (preferido == INDICE_AUTOMATICO && !cabe_no_bitmap)) return 1;
+    if (!cabe_no_bitmap) return 1; // bitmap pedido mas impossível: continua como hash
+
+    return indice_cursos_para_bitmap(indice, palavras);
+}
+
+int indice_cursos_para_bitmap(IndiceCursos* indice, size_t palavras) {
+    uint64_t* bitmap = calloc(palavras, sizeof(uint64_t));
+    if (!bitmap) return 0;
+    for (size_t i = 0; i < indice->tamanho; i++) {
+        int32_t codigo = indice->tabela[i];
+        if (codigo != INDICE_SLOT_VAZIO) bitmap[(uint32_t)codigo >> 6] |= (uint64_t)1 << ((uint32_t)codigo & 63);
+    }
+    free(indice->tabela);
+    indice->tabela = NULL;
+    indice->bitmap = bitmap;
+    indice->tamanho = palavras;
+    indice->tipo = INDICE_BITMAP;
+    return 1;
+}
+
+void indice_cursos_recontar(IndiceCursos* indice) {
+    indice->quantidade = 0;
+    for (size_t i = 0; i < indice->tamanho; i++) indice->quantidade += __builtin_popcountll(indice->bitmap[i]);
+}
+
+int indice_cursos_listar(const IndiceCursos* indice, int32_t* destino) {
+    int quantidade = 0;
+    if (indice->tipo == INDICE_BITMAP) {
+        for (size_t i = 0; i < indice->tamanho; i++) {
+            for (uint64_t palavra = indice->bitmap[i]; palavra; palavra &= palavra - 1) {
+                destino[quantidade++] = (int32_t)(i * 64 + (size_t)__builtin_ctzll(palavra));
+            }
+        }
+    } else {
+        for (size_t i = 0; i < indice->tamanho; i++) {
+            if (indice->tabela[i] != INDICE_SLOT_VAZIO) destino[quantidade++] = indice->tabela[i];
+        }
+    }
+    return quantidade;
+}
+
+void indice_cursos_liberar(IndiceCursos* indice) {
+    free(indice->bitmap);
+    free(indice->tabela);
+    indice_cursos_iniciar(indice);
+}
@@ -0,0 +1,59 @@
+#ifndef INDICE_CURSOS_H
+#define INDICE_CURSOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Conjunto de códigos de curso (CO_CURSO) com consulta em tempo constante.
+// Durante a construção os códigos ficam numa tabela hash de endereçamento aberto; ao finalizar,
+// se os códigos forem densos o bastante, a tabela é trocada por um bitmap indexado pelo próprio código.
+typedef enum {
+    INDICE_AUTOMATICO, // escolhe bitmap ou hash pelo intervalo dos códigos
+    INDICE_BITMAP,
+    INDICE_HASH
+} TipoIndice;
+
+#define INDICE_SLOT_VAZIO INT32_MIN
+#define INDICE_LIMITE_BITMAP_BYTES (16u << 20) // acima disso (códigos > ~134 milhões) usa hash
+
+typedef struct {
+    TipoIndice tipo;      // INDICE_BITMAP ou INDICE_HASH depois de finalizado
+    int quantidade;       // códigos distintos inseridos
+    int codigo_maximo;
+    int codigo_minimo;
+    uint64_t* bitmap;     // INDICE_BITMAP: bit c ligado se o código c está no conjunto
+    int32_t* tabela;      // INDICE_HASH: slots com sondagem linear, INDICE_SLOT_VAZIO nos livres
+    size_t tamanho;       // palavras do bitmap ou slots da tabela (potência de 2)
+} IndiceCursos;
+
+void indice_cursos_iniciar(IndiceCursos* indice);
+// Insere um código; retorna 1 se ele ainda não estava no conjunto, 0 se já estava e -1 se faltou memória.
+int indice_cursos_inserir(IndiceCursos* indice, int codigo);
+// Troca a representação de construção pela definitiva. Retorna 0 se faltou memória.
+int indice_cursos_finalizar(IndiceCursos* indice, TipoIndice preferido);
+// Converte para bitmap com 'palavras' palavras (pelo menos as necessárias para o maior código), para que
+// vários processos tenham bitmaps do mesmo tamanho e possam uni-los. Retorna 0 se faltou memória.
+int indice_cursos_para_bitmap(IndiceCursos* indice, size_t palavras);
+// Recalcula a quantidade a partir do bitmap, depois de uma união feita por fora (MPI_Allreduce com MPI_BOR).
+void indice_cursos_recontar(IndiceCursos* indice);
+// Copia os códigos do conjunto para 'destino' (com espaço para 'quantidade' códigos). Retorna quantos foram copiados.
+int indice_cursos_listar(const IndiceCursos* indice, int32_t* destino);
+void indice_cursos_liberar(IndiceCursos* indice);
+
+static inline uint32_t indice_cursos_hash(int codigo, size_t tamanho) {
+    return ((uint32_t)codigo * 2654435761u) & (uint32_t)(tamanho - 1);
+}
+
+static inline int indice_cursos_contem(const IndiceCursos* indice, int codigo) {
+    if (indice->tipo == INDICE_BITMAP) {
+        uint32_t c = (uint32_t)codigo;
+        return c < (uint32_t)indice->tamanho * 64u && ((indice->bitmap[c >> 6] >> (c & 63)) & 1u);
+    }
+    if (indice->tamanho == 0) return 0;
+    for (uint32_t i = indice_cursos_hash(codigo, indice->tamanho);; i = (i + 1) & (uint32_t)(indice->tamanho - 1)) {
+        if (indice->tabela[i] == codigo) return 1;
+        if (indice->tabela[i] == INDICE_SLOT_VAZIO) return 0;
+    }
+}
+
+#endif
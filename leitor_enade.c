@@ -0,0 +1,317 @@
+#define _GNU_SOURCE // memrchr()
+#include "leitor_enade.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "metricas_enade.h"
+
+static size_t tamanho_bloco_configurado = TAMANHO_BLOCO_LEITURA_PADRAO;
+static int num_buffers_configurado = NUM_BUFFERS_LEITURA_PADRAO;
+
+void leitor_configurar(size_t tamanho_bloco, int num_buffers) {
+    tamanho_bloco_configurado = tamanho_bloco;
+    num_buffers_configurado = num_buffers;
+}
+
+// Lê o próximo pedaço do arquivo no buffer. Retorna 0 no fim do arquivo.
+static int preencher_buffer(LeitorDeLinhas* leitor, BufferDeLeitura* buffer) {
+    if (leitor->descompressor) {
+        size_t produzidos = descompressor_ler(leitor->descompressor, buffer->dados, leitor->tamanho_bloco);
+        if (produzidos == 0) {
+            leitor->erro_dados = leitor->descompressor->erro;
+            return 0;
+        }
+        buffer->tamanho = produzidos;
+        buffer->offset = leitor->posicao_arquivo;
+        leitor->posicao_arquivo += (off_t)produzidos;
+        return 1;
+    }
+
+    if (leitor->cauda_completa) return 0;
+    size_t tamanho = leitor->tamanho_bloco;
+    if (leitor->limite != LEITOR_SEM_LIMITE) {
+        if (leitor->posicao_arquivo >= leitor->limite) {
+            if (tamanho > TAMANHO_CAUDA_LEITURA) tamanho = TAMANHO_CAUDA_LEITURA;
+        } else if ((off_t)tamanho > leitor->limite - leitor->posicao_arquivo) {
+            tamanho = (size_t)(leitor->limite - leitor->posicao_arquivo);
+        }
+    }
+    ssize_t lidos = pread(leitor->descritor, buffer->dados, tamanho, leitor->posicao_arquivo);
+    if (lidos <= 0) return 0;
+    buffer->tamanho = (size_t)lidos;
+    buffer->offset = leitor->posicao_arquivo;
+    leitor->posicao_arquivo += lidos;
+
+    // A última linha do intervalo é a que contém o byte limite - 1: acabou no primeiro '\n' dali em diante.
+    // Sem isso a thread leitora continuaria enchendo todos os buffers livres com caudas que ninguém usa.
+    if (leitor->limite != LEITOR_SEM_LIMITE && leitor->posicao_arquivo >= leitor->limite) {
+        off_t desde = (leitor->limite - 1 > buffer->offset) ? leitor->limite - 1 : buffer->offset;
+        leitor->cauda_completa = memchr(buffer->dados + (desde - buffer->offset), '\n', (size_t)(leitor->posicao_arquivo - desde)) != NULL;
+    }
+    return 1;
+}
+
+// Thread leitora: preenche os buffers em rodízio, sempre um à frente do consumidor.
+static void* ler_em_segundo_plano(void* argumento) {
+    LeitorDeLinhas* leitor = argumento;
+    pthread_mutex_lock(&leitor->trava);
+    for (int i = 0;; i = (i + 1) % leitor->num_buffers) {
+        while (leitor->buffers[i].cheio && !leitor->parar) pthread_cond_wait(&leitor->buffer_vazio, &leitor->trava);
+        if (leitor->parar) break;
+        pthread_mutex_unlock(&leitor->trava);
+        int ok = preencher_buffer(leitor, &leitor->buffers[i]);
+        pthread_mutex_lock(&leitor->trava);
+        if (!ok) {
+            leitor->fim_do_arquivo = 1;
+            pthread_cond_signal(&leitor->buffer_cheio);
+            break;
+        }
+        leitor->buffers[i].cheio = 1;
+        pthread_cond_signal(&leitor->buffer_cheio);
+    }
+    pthread_mutex_unlock(&leitor->trava);
+    return NULL;
+}
+
+// Aloca os buffers e, com dois ou mais, inicia a thread leitora.
+static int leitor_comecar(LeitorDeLinhas* leitor) {
+    leitor->buffers = calloc((size_t)leitor->num_buffers, sizeof(BufferDeLeitura));
+    if (!leitor->buffers) return 0;
+    for (int i = 0; i < leitor->num_buffers; i++) {
+        leitor->buffers[i].dados = malloc(leitor->tamanho_bloco);
+        if (!leitor->buffers[i].dados) return 0;
+    }
+
+    if (leitor->num_buffers > 1) {
+        pthread_mutex_init(&leitor->trava, NULL);
+        pthread_cond_init(&leitor->buffer_cheio, NULL);
+        pthread_cond_init(&leitor->buffer_vazio, NULL);
+        leitor->assincrono = pthread_create(&leitor->thread, NULL, ler_em_segundo_plano, leitor) == 0;
+        if (!leitor->assincrono) { // sem thread, lê de forma síncrona
+            pthread_mutex_destroy(&leitor->trava);
+            pthread_cond_destroy(&leitor->buffer_cheio);
+            pthread_cond_destroy(&leitor->buffer_vazio);
+        }
+    }
+    return 1;
+}
+
+int leitor_iniciar(LeitorDeLinhas* leitor, int descritor, off_t posicao, off_t limite) {
+    memset(leitor, 0, sizeof(*leitor));
+    leitor->descritor = descritor;
+    leitor->posicao_arquivo = posicao;
+    leitor->limite = limite;
+    leitor->buffer_atual = -1;
+    leitor->num_buffers = num_buffers_configurado;
+    leitor->tamanho_bloco = tamanho_bloco_configurado;
+    if (limite != LEITOR_SEM_LIMITE) {
+        off_t intervalo = limite - posicao;
+        // Com um bloco só por intervalo, o parser esperaria a leitura inteira antes de começar e a thread
+        // leitora só adiantaria caudas: o intervalo é dividido em blocos menores para a E/S sobrepor o parse.
+        if (leitor->num_buffers > 1) {
+            off_t dividido = intervalo / (BLOCOS_POR_BUFFER * leitor->num_buffers);
+            if (dividido < TAMANHO_MIN_BLOCO_INTERVALO) dividido = TAMANHO_MIN_BLOCO_INTERVALO;
+            if (dividido < (off_t)leitor->tamanho_bloco) leitor->tamanho_bloco = (size_t)dividido;
+        }
+        // Um intervalo pequeno não precisa de buffers do tamanho do bloco.
+        if (intervalo < (off_t)leitor->tamanho_bloco) {
+            leitor->tamanho_bloco = (intervalo > TAMANHO_CAUDA_LEITURA) ? (size_t)intervalo : TAMANHO_CAUDA_LEITURA;
+        }
+    }
+    if (!leitor_comecar(leitor)) {
+        leitor_liberar(leitor);
+        return 0;
+    }
+    return 1;
+}
+
+int leitor_iniciar_compactado(LeitorDeLinhas* leitor, int descritor, const MembroCompactado* membro) {
+    memset(leitor, 0, sizeof(*leitor));
+    leitor->descritor = descritor;
+    leitor->limite = LEITOR_SEM_LIMITE;
+    leitor->buffer_atual = -1;
+    leitor->num_buffers = num_buffers_configurado;
+    leitor->tamanho_bloco = tamanho_bloco_configurado;
+    leitor->descompressor = malloc(sizeof(Descompressor));
+    if (!leitor->descompressor || !descompressor_iniciar(leitor->descompressor, descritor, membro)) {
+        free(leitor->descompressor);
+        leitor->descompressor = NULL;
+        return 0;
+    }
+    if (!leitor_comecar(leitor)) {
+        leitor_liberar(leitor);
+        return 0;
+    }
+    return 1;
+}
+
+void leitor_liberar(LeitorDeLinhas* leitor) {
+    if (leitor->assincrono) {
+        pthread_mutex_lock(&leitor->trava);
+        leitor->parar = 1;
+        pthread_cond_signal(&leitor->buffer_vazio);
+        pthread_mutex_unlock(&leitor->trava);
+        pthread_join(leitor->thread, NULL);
+        pthread_mutex_destroy(&leitor->trava);
+        pthread_cond_destroy(&leitor->buffer_cheio);
+        pthread_cond_destroy(&leitor->buffer_vazio);
+        leitor->assincrono = 0;
+    }
+    if (leitor->buffers) {
+        for (int i = 0; i < leitor->num_buffers; i++) free(leitor->buffers[i].dados);
+    }
+    free(leitor->buffers);
+    free(leitor->juncao);
+    if (leitor->descompressor) {
+        descompressor_liberar(leitor->descompressor);
+        free(leitor->descompressor);
+    }
+    leitor->buffers = NULL;
+    leitor->descompressor = NULL;
+    leitor->juncao = NULL;
+}
+
+// Passa a percorrer o próximo buffer preenchido. Retorna 0 quando não há mais nada para ler.
+static int leitor_obter_buffer(LeitorDeLinhas* leitor) {
+    double inicio = metricas_agora();
+    int proximo = leitor->proximo_buffer;
+    if (leitor->assincrono) {
+        pthread_mutex_lock(&leitor->trava);
+        while (!leitor->buffers[proximo].cheio && !leitor->fim_do_arquivo) pthread_cond_wait(&leitor->buffer_cheio, &leitor->trava);
+        int cheio = leitor->buffers[proximo].cheio;
+        pthread_mutex_unlock(&leitor->trava);
+        if (!cheio) return 0;
+    } else {
+        if (leitor->fim_do_arquivo) return 0;
+        if (!preencher_buffer(leitor, &leitor->buffers[proximo])) {
+            leitor->fim_do_arquivo = 1;
+            return 0;
+        }
+    }
+    leitor->tempo_leitura += metricas_agora() - inicio;
+    leitor->bytes_lidos += (long long)leitor->buffers[proximo].tamanho;
+    leitor->buffer_atual = proximo;
+    leitor->inicio = 0;
+    return 1;
+}
+
+// Devolve o buffer atual para a thread leitora.
+static void leitor_soltar_buffer(LeitorDeLinhas* leitor) {
+    if (leitor->assincrono) {
+        pthread_mutex_lock(&leitor->trava);
+        leitor->buffers[leitor->buffer_atual].cheio = 0;
+        pthread_cond_signal(&leitor->buffer_vazio);
+        pthread_mutex_unlock(&leitor->trava);
+    }
+    leitor->proximo_buffer = (leitor->buffer_atual + 1) % leitor->num_buffers;
+    leitor->buffer_atual = -1;
+}
+
+// Acrescenta bytes à linha partida. Retorna 0 se faltou memória.
+static int leitor_juntar(LeitorDeLinhas* leitor, const char* dados, size_t tamanho, off_t offset) {
+    if (leitor->tamanho_juncao == 0) leitor->offset_juncao = offset;
+    if (leitor->tamanho_juncao + tamanho > leitor->capacidade_juncao) {
+        size_t nova_capacidade = leitor->capacidade_juncao ? leitor->capacidade_juncao : 4096;
+        while (nova_capacidade < leitor->tamanho_juncao + tamanho) nova_capacidade *= 2;
+        char* ponteiro_temp = realloc(leitor->juncao, nova_capacidade);
+        if (!ponteiro_temp) {
+            leitor->erro = 1;
+            return 0;
+        }
+        leitor->juncao = ponteiro_temp;
+        leitor->capacidade_juncao = nova_capacidade;
+    }
+    memcpy(leitor->juncao + leitor->tamanho_juncao, dados, tamanho);
+    leitor->tamanho_juncao += tamanho;
+    return 1;
+}
+
+int leitor_proximo_bloco(LeitorDeLinhas* leitor, const char** bloco, const char** fim_bloco, off_t* offset_bloco) {
+    if (leitor->erro) return 0;
+    if (leitor->juncao_entregue) {
+        leitor->tamanho_juncao = 0;
+        leitor->juncao_entregue = 0;
+    }
+    for (;;) {
+        if (leitor->buffer_atual < 0) {
+            if (!leitor_obter_buffer(leitor)) {
+                // Parando no limite, o que sobrou depois do último '\n' é começo de uma linha de fora do intervalo.
+                if (leitor->tamanho_juncao == 0 || leitor->cauda_completa) return 0;
+                // última linha do arquivo, sem '\n'
+                *bloco = leitor->juncao;
+                *fim_bloco = leitor->juncao + leitor->tamanho_juncao;
+                *offset_bloco = leitor->offset_juncao;
+                leitor->juncao_entregue = 1;
+                return 1;
+            }
+            if (leitor->tamanho_juncao > 0) { // completa a linha partida com o começo deste buffer
+                const BufferDeLeitura* buffer = &leitor->buffers[leitor->buffer_atual];
+                const char* quebra = memchr(buffer->dados, '\n', buffer->tamanho);
+                size_t usados = quebra ? (size_t)(quebra - buffer->dados) + 1 : buffer->tamanho;
+                if (!leitor_juntar(leitor, buffer->dados, usados, buffer->offset)) return 0;
+                leitor->inicio = usados;
+                if (quebra) {
+                    *bloco = leitor->juncao;
+                    *fim_bloco = leitor->juncao + leitor->tamanho_juncao;
+                    *offset_bloco = leitor->offset_juncao;
+                    leitor->juncao_entregue = 1;
+                    return 1;
+                }
+                leitor_soltar_buffer(leitor); // linha maior que o buffer inteiro
+                continue;
+            }
+        }
+
+        BufferDeLeitura* buffer = &leitor->buffers[leitor->buffer_atual];
+        char* inicio = buffer->dados + leitor->inicio;
+        size_t restante = buffer->tamanho - leitor->inicio;
+        char* ultima_quebra = restante ? memrchr(inicio, '\n', restante) : NULL;
+        if (!ultima_quebra) { // o resto do buffer é começo de linha: guarda até chegar o próximo
+            if (restante && !leitor_juntar(leitor, inicio, restante, buffer->offset + (off_t)leitor->inicio)) return 0;
+            leitor_soltar_buffer(leitor);
+            continue;
+        }
+        *bloco = inicio;
+        *fim_bloco = ultima_quebra + 1;
+        *offset_bloco = buffer->offset + (off_t)leitor->inicio;
+        leitor->inicio = (size_t)(*fim_bloco - buffer->dados);
+        return 1;
+    }
+}
+
+int cursor_abrir(CursorDeLinhas* cursor, int descritor, off_t inicio, off_t limite) {
+    memset(cursor, 0, sizeof(*cursor));
+    // Fora do começo do arquivo, parte um byte antes e descarta o resto da linha anterior
+    // (se 'inicio' já for começo de linha, descarta só o '\n').
+    if (!leitor_iniciar(&cursor->leitor, descritor, (inicio == 0) ? 0 : inicio - 1, limite)) return 0;
+    if (cursor_tem_linha(cursor)) cursor_pular_linha(cursor);
+    return 1;
+}
+
+void cursor_fechar(CursorDeLinhas* cursor) {
+    leitor_liberar(&cursor->leitor);
+}
+
+int cursor_tem_linha(CursorDeLinhas* cursor) {
+    if (cursor->linha < cursor->fim_bloco) return 1;
+    if (!leitor_proximo_bloco(&cursor->leitor, &cursor->bloco, &cursor->fim_bloco, &cursor->offset_bloco)) return 0;
+    cursor->linha = cursor->bloco;
+    return 1;
+}
+
+off_t cursor_offset(const CursorDeLinhas* cursor) {
+    return cursor->offset_bloco + (cursor->linha - cursor->bloco);
+}
+
+void cursor_pular_linha(CursorDeLinhas* cursor) {
+    const char* quebra = memchr(cursor->linha, '\n', (size_t)(cursor->fim_bloco - cursor->linha));
+    cursor->linha = quebra ? quebra + 1 : cursor->fim_bloco;
+}
+
+int cursor_ler_registro(CursorDeLinhas* cursor, ModoParser modo_parser, RegistroDados* registro) {
+    if (!cursor_tem_linha(cursor)) return 0;
+    cursor->linha = parser_linha_dados(cursor->linha, cursor->fim_bloco, modo_parser, registro);
+    return 1;
+}
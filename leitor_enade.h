@@ -0,0 +1,102 @@
+#ifndef LEITOR_ENADE_H
+#define LEITOR_ENADE_H
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "compactado_enade.h"
+#include "parser_enade.h"
+
+#include <pthread.h>
+
+#define TAMANHO_BLOCO_LEITURA_PADRAO (4 << 20) // 4 MB por pread
+#define NUM_BUFFERS_LEITURA_PADRAO 2             // um sendo lido do disco enquanto o outro é percorrido
+#define TAMANHO_CAUDA_LEITURA (4 << 10)          // depois do limite, lê de página em página até terminar a última linha
+#define BLOCOS_POR_BUFFER 4                      // com limite, o intervalo é dividido em pelo menos 4 blocos por buffer
+#define TAMANHO_MIN_BLOCO_INTERVALO (256 << 10)  // ... mas sem descer abaixo de 256 KB por pread
+#define LEITOR_SEM_LIMITE ((off_t)-1)
+
+// Um bloco lido do disco. Com leitura assíncrona, fica com a thread leitora enquanto não está 'cheio'
+// e com o consumidor enquanto está.
+typedef struct {
+    char* dados;
+    size_t tamanho;
+    off_t offset;           // offset no arquivo do primeiro byte
+    int cheio;
+} BufferDeLeitura;
+
+// Leitor em blocos com pread a partir de um offset do arquivo, ou descompactando um membro de .zip/.gz
+// (aí os offsets são do texto descompactado). Entrega trechos dos buffers formados só por
+// linhas completas, para o parser percorrer sem cópia. Com dois ou mais buffers, uma thread leitora
+// carrega o bloco k+1 enquanto o bloco k é percorrido; a linha partida entre dois blocos é juntada
+// numa área própria e entregue como um trecho à parte.
+typedef struct {
+    int descritor;
+    off_t posicao_arquivo;  // offset do próximo byte a ser lido do disco (só a thread leitora mexe)
+    off_t limite;           // até aqui lê blocos inteiros; depois, só pedaços de TAMANHO_CAUDA_LEITURA
+    int cauda_completa;     // já leu o '\n' que fecha a linha que começou antes do limite: não lê mais nada
+    size_t tamanho_bloco;
+    int num_buffers;
+    BufferDeLeitura* buffers;
+    Descompressor* descompressor; // NULL para texto puro
+
+    // Estado do consumidor.
+    int buffer_atual;       // buffer sendo percorrido, ou -1
+    int proximo_buffer;     // próximo buffer a ser consumido
+    size_t inicio;          // parte ainda não entregue do buffer atual
+    char* juncao;           // linha partida entre dois buffers
+    size_t tamanho_juncao, capacidade_juncao;
+    off_t offset_juncao;
+    int juncao_entregue;
+
+    int assincrono;
+    int fim_do_arquivo;     // a leitura terminou: nenhum buffer vazio volta a ser preenchido
+    int parar;              // pedido do consumidor para a thread leitora encerrar
+    pthread_t thread;
+    pthread_mutex_t trava;
+    pthread_cond_t buffer_cheio, buffer_vazio;
+
+    int erro;               // faltou memória para uma linha maior que o buffer
+    int erro_dados;         // o conteúdo compactado está corrompido ou truncado
+    double tempo_leitura;   // segundos esperando o disco (no pread ou aguardando a thread leitora)
+    long long bytes_lidos;  // bytes dos blocos entregues ao consumidor
+} LeitorDeLinhas;
+
+// Tamanho dos blocos e número de buffers de todos os leitores criados daqui em diante (1 buffer: pread
+// síncrono, sem thread). Chamar antes de abrir leitores em outras threads.
+void leitor_configurar(size_t tamanho_bloco, int num_buffers);
+// Prepara o leitor para começar em 'posicao'. Blocos inteiros são lidos só até 'limite' (LEITOR_SEM_LIMITE
+// para ler até o fim do arquivo); depois dele o leitor continua, em pedaços pequenos e um de cada vez, só até
+// completar a linha que começou antes do limite, e então se comporta como no fim do arquivo. Com leitura assíncrona, um intervalo curto (um chunk) é lido em blocos
+// menores que o configurado, para que a thread leitora tenha blocos para adiantar. Retorna 0 se faltar memória.
+int leitor_iniciar(LeitorDeLinhas* leitor, int descritor, off_t posicao, off_t limite);
+// Prepara o leitor para o conteúdo descompactado de um membro, do começo ao fim. Retorna 0 se faltar memória.
+int leitor_iniciar_compactado(LeitorDeLinhas* leitor, int descritor, const MembroCompactado* membro);
+void leitor_liberar(LeitorDeLinhas* leitor);
+// Devolve o próximo trecho formado só por linhas completas (a última linha do arquivo pode vir sem '\n')
+// e o offset do seu primeiro byte no arquivo. O trecho vale até a próxima chamada. Retorna 0 no fim do
+// arquivo ou em erro.
+int leitor_proximo_bloco(LeitorDeLinhas* leitor, const char** bloco, const char** fim_bloco, off_t* offset_bloco);
+
+// Percorre as linhas uma a uma, para quem precisa avançar vários arquivos em paralelo.
+typedef struct {
+    LeitorDeLinhas leitor;
+    const char* bloco;
+    const char* fim_bloco;
+    const char* linha;      // linha atual dentro do bloco
+    off_t offset_bloco;
+} CursorDeLinhas;
+
+// Posiciona o cursor na primeira linha que começa em 'inicio' ou depois (em 0, pula o cabeçalho).
+// 'limite' é repassado ao leitor. Retorna 0 se faltar memória.
+int cursor_abrir(CursorDeLinhas* cursor, int descritor, off_t inicio, off_t limite);
+void cursor_fechar(CursorDeLinhas* cursor);
+// Garante que há uma linha atual. Retorna 0 no fim do arquivo.
+int cursor_tem_linha(CursorDeLinhas* cursor);
+// Offset no arquivo do primeiro byte da linha atual (chamar só depois de cursor_tem_linha).
+off_t cursor_offset(const CursorDeLinhas* cursor);
+void cursor_pular_linha(CursorDeLinhas* cursor);
+// Lê a linha atual e avança para a próxima. Retorna 0 no fim do arquivo.
+int cursor_ler_registro(CursorDeLinhas* cursor, ModoParser modo_parser, RegistroDados* registro);
+
+#endif
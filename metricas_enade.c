@@ -0,0 +1,176 @@
+#include "metricas_enade.h"
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Campos enviados por processo no MPI_Gather: os do processo, depois os de cada arquivo.
+#define CAMPOS_PROCESSO 5
+#define CAMPOS_ARQUIVO 5
+
+void metricas_somar_arquivo(MetricasArquivo* destino, const MetricasArquivo* origem) {
+    destino->leitura += origem->leitura;
+    destino->parse += origem->parse;
+    destino->contagem += origem->contagem;
+    destino->bytes += origem->bytes;
+    destino->linhas += origem->linhas;
+}
+
+static void empacotar(const MetricasProcesso* metricas, int num_arquivos, double* destino) {
+    destino[0] = metricas->carga_arq1;
+    destino[1] = metricas->coletivas;
+    destino[2] = metricas->espera;
+    destino[3] = metricas->trabalho;
+    destino[4] = metricas->chunks;
+    for (int i = 0; i < num_arquivos; i++) {
+        const MetricasArquivo* arquivo = &metricas->arquivos[i];
+        double* campos = destino + CAMPOS_PROCESSO + i * CAMPOS_ARQUIVO;
+        campos[0] = arquivo->leitura;
+        campos[1] = arquivo->parse;
+        campos[2] = arquivo->contagem;
+        campos[3] = arquivo->bytes;
+        campos[4] = arquivo->linhas;
+    }
+}
+
+static void desempacotar(const double* origem, int num_arquivos, MetricasProcesso* metricas) {
+    memset(metricas, 0, sizeof(*metricas));
+    metricas->carga_arq1 = origem[0];
+    metricas->coletivas = origem[1];
+    metricas->espera = origem[2];
+    metricas->trabalho = origem[3];
+    metricas->chunks = origem[4];
+    for (int i = 0; i < num_arquivos; i++) {
+        const double* campos = origem + CAMPOS_PROCESSO + i * CAMPOS_ARQUIVO;
+        MetricasArquivo arquivo = { campos[0], campos[1], campos[2], campos[3], campos[4] };
+        metricas->arquivos[i] = arquivo;
+    }
+}
+
+// Linhas da tabela de fases. As de leitura, parse, contagem, bytes e linhas somam todos os arquivos.
+typedef enum {
+    FASE_CARGA_ARQ1, FASE_LEITURA, FASE_PARSE, FASE_CONTAGEM, FASE_COLETIVAS, FASE_ESPERA, FASE_TRABALHO,
+    FASE_CHUNKS, FASE_MEGABYTES, FASE_LINHAS, NUM_FASES
+} Fase;
+
+static const char* NOMES_FASES[NUM_FASES] = {
+    "Carga do arq1 (s)", "Leitura/E-S (s)", "Parse (s)", "Filtro e contagem (s)", "Coletivas MPI (s)",
+    "Espera (s)", "Trabalho (s)", "Chunks", "Lido (MB)", "Linhas"
+};
+
+static double valor_da_fase(const MetricasProcesso* metricas, Fase fase, int num_arquivos) {
+    switch (fase) {
+        case FASE_CARGA_ARQ1: return metricas->carga_arq1;
+        case FASE_COLETIVAS: return metricas->coletivas;
+        case FASE_ESPERA: return metricas->espera;
+        case FASE_TRABALHO: return metricas->trabalho;
+        case FASE_CHUNKS: return metricas->chunks;
+        default: break;
+    }
+    double soma = 0;
+    for (int i = 0; i < num_arquivos; i++) {
+        const MetricasArquivo* arquivo = &metricas->arquivos[i];
+        if (fase == FASE_LEITURA) soma += arquivo->leitura;
+        else if (fase == FASE_PARSE) soma += arquivo->parse;
+        else if (fase == FASE_CONTAGEM) soma += arquivo->contagem;
+        else if (fase == FASE_MEGABYTES) soma += arquivo->bytes / (1 << 20);
+        else soma += arquivo->linhas;
+    }
+    return soma;
+}
+
+// Uma linha da tabela: mínimo, média e máximo entre os processos e o desbalanceamento (máx/média - 1).
+static void imprimir_linha(const char* nome, const double* valores, int num_processos, int inteiro) {
+    double minimo = valores[0], maximo = valores[0], soma = 0;
+    for (int r = 0; r < num_processos; r++) {
+        if (valores[r] < minimo) minimo = valores[r];
+        if (valores[r] > maximo) maximo = valores[r];
+        soma += valores[r];
+    }
+    double media = soma / num_processos;
+    if (inteiro) printf("   %-22s %12.0f %12.1f %12.0f", nome, minimo, media, maximo);
+    else printf("   %-22s %12.4f %12.4f %12.4f", nome, minimo, media, maximo);
+    if (media > 0) printf(" %15.1f%%", (maximo / media - 1.0) * 100.0);
+    printf("\n");
+}
+
+static const char* nome_curto(const char* arquivo) {
+    const char* barra = strrchr(arquivo, '/');
+    return barra ? barra + 1 : arquivo;
+}
+
+static void gravar_json(const char* caminho, const MetricasProcesso* todos, const char** arquivos, int num_arquivos, int num_processos,
+                        const char* agendamento, int num_threads) {
+    FILE* saida = fopen(caminho, "w");
+    if (!saida) {
+        fprintf(stderr, "Aviso: não foi possível gravar '%s'.\n", caminho);
+        return;
+    }
+    fprintf(saida, "{\n  \"processos\": %d,\n  \"threads_por_processo\": %d,\n  \"agendamento\": \"%s\",\n  \"por_processo\": [",
+            num_processos, num_threads, agendamento);
+    for (int r = 0; r < num_processos; r++) {
+        const MetricasProcesso* metricas = &todos[r];
+        fprintf(saida, "%s\n    {\"rank\": %d, \"carga_arq1\": %.6f, \"coletivas\": %.6f, \"espera\": %.6f, \"trabalho\": %.6f, \"chunks\": %.0f, \"arquivos\": [",
+                r == 0 ? "" : ",", r, metricas->carga_arq1, metricas->coletivas, metricas->espera, metricas->trabalho, metricas->chunks);
+        for (int i = 0; i < num_arquivos; i++) {
+            const MetricasArquivo* arquivo = &metricas->arquivos[i];
+            fprintf(saida, "%s\n      {\"arquivo\": \"%s\", \"leitura\": %.6f, \"parse\": %.6f, \"contagem\": %.6f, \"bytes\": %.0f, \"linhas\": %.0f}",
+                    i == 0 ? "" : ",", arquivos[i], arquivo->leitura, arquivo->parse, arquivo->contagem, arquivo->bytes, arquivo->linhas);
+        }
+        fprintf(saida, "\n    ]}");
+    }
+    fprintf(saida, "\n  ]\n}\n");
+    fclose(saida);
+}
+
+void metricas_relatar(const MetricasProcesso* metricas, const char** arquivos, int num_arquivos, int rank_processo, int num_processos,
+                      const char* agendamento, int num_threads, const char* caminho_json) {
+    int campos = CAMPOS_PROCESSO + num_arquivos * CAMPOS_ARQUIVO;
+    double* locais = malloc(sizeof(double) * (size_t)campos);
+    double* recebidos = (rank_processo == 0) ? malloc(sizeof(double) * (size_t)campos * num_processos) : NULL;
+    MetricasProcesso* todos = (rank_processo == 0) ? malloc(sizeof(MetricasProcesso) * (size_t)num_processos) : NULL;
+    double* valores = (rank_processo == 0) ? malloc(sizeof(double) * (size_t)num_processos) : NULL;
+    if (!locais || (rank_processo == 0 && (!recebidos || !todos || !valores))) {
+        fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    empacotar(metricas, num_arquivos, locais);
+    MPI_Gather(locais, campos, MPI_DOUBLE, recebidos, campos, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    free(locais);
+    if (rank_processo != 0) return;
+
+    for (int r = 0; r < num_processos; r++) desempacotar(recebidos + (size_t)r * campos, num_arquivos, &todos[r]);
+    free(recebidos);
+
+    printf("\nBalanceamento de carga (agendamento %s, %d threads por processo):\n", agendamento, num_threads);
+    printf("   %-22s %12s %12s %12s %16s\n", "", "mín", "média", "máx", "desbalanceamento");
+    for (int fase = 0; fase < NUM_FASES; fase++) {
+        for (int r = 0; r < num_processos; r++) valores[r] = valor_da_fase(&todos[r], (Fase)fase, num_arquivos);
+        imprimir_linha(NOMES_FASES[fase], valores, num_processos, fase == FASE_CHUNKS || fase == FASE_LINHAS);
+    }
+
+    // Por arquivo: a soma dos processos e o desbalanceamento do tempo gasto no arquivo.
+    printf("\nPor arquivo (soma dos processos, em segundos de thread):\n");
+    printf("   %-26s %10s %10s %10s %10s %12s %16s\n", "", "leitura", "parse", "contagem", "MB", "linhas", "desbalanceamento");
+    for (int i = 0; i < num_arquivos; i++) {
+        MetricasArquivo total = {0};
+        double maximo = 0;
+        for (int r = 0; r < num_processos; r++) {
+            const MetricasArquivo* arquivo = &todos[r].arquivos[i];
+            metricas_somar_arquivo(&total, arquivo);
+            double tempo = arquivo->leitura + arquivo->parse + arquivo->contagem;
+            if (tempo > maximo) maximo = tempo;
+        }
+        double media = (total.leitura + total.parse + total.contagem) / num_processos;
+        printf("   %-26s %10.4f %10.4f %10.4f %10.1f %12.0f", nome_curto(arquivos[i]), total.leitura, total.parse, total.contagem,
+               total.bytes / (1 << 20), total.linhas);
+        if (media > 0) printf(" %15.1f%%", (maximo / media - 1.0) * 100.0);
+        printf("\n");
+    }
+
+    if (caminho_json) gravar_json(caminho_json, todos, arquivos, num_arquivos, num_processos, agendamento, num_threads);
+    free(todos);
+    free(valores);
+}
@@ -0,0 +1,45 @@
+#ifndef METRICAS_ENADE_H
+#define METRICAS_ENADE_H
+
+#include <time.h>
+
+// Instrumentação por processo e por arquivo, barata o bastante para ficar sempre ligada: os tempos são
+// tomados por lote de linhas ou por chamada de E/S, nunca por linha. Ao final, tudo é juntado no processo 0
+// com um MPI_Gather e mostrado como mínimo/média/máximo/desbalanceamento entre os processos.
+
+#define METRICAS_MAX_ARQUIVOS 32
+
+// Fases de leitura, parse e contagem são somadas entre as threads do processo (segundos de thread).
+typedef struct {
+    double leitura;   // E/S (pread); no cache colunar o acesso ao mmap fica dentro da contagem
+    double parse;
+    double contagem;  // filtro por curso e incremento dos contadores
+    double bytes;     // bytes lidos do disco (ou do cache)
+    double linhas;    // linhas processadas
+} MetricasArquivo;
+
+typedef struct {
+    double carga_arq1; // leitura da parte do arq1 que cabe a este processo e montagem dos conjuntos locais
+    double coletivas;  // união dos cursos (MPI_Allgather/MPI_Allgatherv ou MPI_Allreduce com MPI_BOR),
+                       // MPI_Allreduce, MPI_Reduce e o fetch-and-add dos chunks
+    double espera;     // barreiras
+    double trabalho;   // tempo de parede processando os arquivos de dados
+    double chunks;
+    MetricasArquivo arquivos[METRICAS_MAX_ARQUIVOS];
+} MetricasProcesso;
+
+// Relógio monotônico em segundos. Não chama o MPI, então pode ser usado pelas threads OpenMP.
+static inline double metricas_agora(void) {
+    struct timespec agora;
+    clock_gettime(CLOCK_MONOTONIC, &agora);
+    return (double)agora.tv_sec + (double)agora.tv_nsec * 1e-9;
+}
+
+void metricas_somar_arquivo(MetricasArquivo* destino, const MetricasArquivo* origem);
+
+// Junta as métricas de todos os processos no processo 0, mostra a tabela e, se 'caminho_json' não for NULL,
+// grava os números brutos de cada processo em JSON. É coletiva.
+void metricas_relatar(const MetricasProcesso* metricas, const char** arquivos, int num_arquivos, int rank_processo, int num_processos,
+                      const char* agendamento, int num_threads, const char* caminho_json);
+
+#endif
@@ -2,107 +2,723 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "cache_enade.h"
+#include "compactado_enade.h"
+#include "cruzamento_enade.h"
+#include "exportacao_enade.h"
+#include "grupos_cursos.h"
+#include "indice_cursos.h"
+#include "leitor_enade.h"
+#include "metricas_enade.h"
+#include "parser_enade.h"
+#include "perguntas_enade.h"
+
+#ifdef _OPENMP
+#include <omp.h>
+#else
+static inline int omp_get_thread_num(void) { return 0; }
+static inline int omp_get_max_threads(void) { return 1; }
+#endif
 
-#define TAMANHO_MAX_LINHA 2048
 #define CODIGO_GRUPO_ADS 72
+#define NUM_MAX_ARQUIVOS METRICAS_MAX_ARQUIVOS
+#define LINHAS_POR_LOTE 4096 // linhas lidas para colunas antes de contar; os tempos de parse e contagem são tomados por lote
+#define TAMANHO_LINHA_DE_CACHE 64
+#define TAMANHO_CHUNK_PADRAO_MB 8
+#define SEM_FIM ((off_t)INT64_MAX) // fim de intervalo para ler um fluxo inteiro
+
+// Modos de divisão do trabalho entre os processos:
+// - intercalada: todos leem o arquivo inteiro e cada um fica com as linhas onde numero_linha % num_processos == rank
+// - particionada: cada processo lê apenas um intervalo contíguo de bytes de cada arquivo
+typedef enum {
+    LEITURA_INTERCALADA,
+    LEITURA_PARTICIONADA
+} ModoLeitura;
+
+// Como os arquivos são repartidos entre os processos:
+// - estatico: arquivo por arquivo, fatias fixas por rank e uma barreira ao fim de cada arquivo
+// - dinamico: todos os arquivos viram chunks distribuídos sob demanda, sem barreiras entre arquivos
+typedef enum {
+    AGENDAMENTO_ESTATICO,
+    AGENDAMENTO_DINAMICO
+} ModoAgendamento;
 
-// Estrutura atualizada para incluir contadores de respostas nulas/inválidas.
-// Todos os nomes de variáveis foram traduzidos para o português.
+// De onde vêm os arquivos de dados:
+// - texto: os .txt descompactados em DADOS/
+// - zip: os membros de mesmo nome dentro do .zip do INEP, descompactados em fluxo
+// - gz: DADOS/<arquivo>.txt.gz, descompactados em fluxo
+typedef enum {
+    FONTE_TEXTO,
+    FONTE_ZIP,
+    FONTE_GZ
+} FonteDados;
+
+typedef struct {
+    ModoLeitura modo_leitura;
+    ModoParser modo_parser;
+    int usar_cache;   // lê o cache colunar (.col) quando ele estiver válido
+    int gerar_cache;  // converte os .txt para o cache antes da análise
+    int num_threads;  // threads OpenMP por processo MPI
+    ModoAgendamento agendamento;
+    long long tamanho_chunk; // bytes por chunk no agendamento dinâmico
+    long long tamanho_bloco; // bytes por leitura do disco
+    int num_buffers;         // buffers em rodízio por leitor (1: pread síncrono, sem thread leitora)
+    EspecificacaoCruzamento cruzamento; // num_dimensoes > 0: monta a tabela cruzada em vez das perguntas
+    int por_grupo;              // conta as perguntas para todos os CO_GRUPO, não só ADS
+    const char* arquivo_csv;    // exportação das contagens (NULL: não exporta)
+    const char* arquivo_json;
+    const char* arquivo_metricas; // JSON com as métricas de cada processo (NULL: só a tabela)
+    FonteDados fonte;
+    const char* arquivo_zip;    // só com FONTE_ZIP
+} Configuracao;
+
+// Contadores de todas as perguntas do registro (perguntas_enade.c) num único vetor contíguo,
+// para que o MPI_Reduce continue sendo uma só redução. No modo por grupo são num_grupos blocos
+// de perguntas_num_contadores() contadores, um por CO_GRUPO.
 typedef struct {
-    long long total_alunos;
-    long long alunas_sexo_feminino;
-    long long alunos_ensino_tecnico;
-    long long total_acao_afirmativa;
-    // Contadores de Incentivo
-    long long incentivo_pais, incentivo_familia, incentivo_professores, incentivo_amigos,
-              incentivo_lider_religioso, incentivo_outros, incentivo_nenhum, incentivo_nulo;
-    // Contadores de Família Graduada
-    long long familia_graduada_sim, familia_graduada_nao, familia_graduada_nulo;
-    // Contadores de Livros
-    long long livros_nenhum, livros_um_a_dois, livros_tres_a_cinco, livros_seis_a_oito, 
-              livros_mais_de_oito, livros_nulo;
-    // Contadores de Horas de Estudo
-    long long horas_estudo_nenhuma, horas_estudo_uma_a_tres, horas_estudo_quatro_a_sete, 
-              horas_estudo_oito_a_doze, horas_estudo_mais_de_doze, horas_estudo_nulo;
+    long long* contadores;
+    int num_contadores;
 } Resultados;
 
-// Função para verificar se um curso já existe na lista para evitar duplicatas.
-int curso_esta_na_lista(int codigo_curso, const int* cursos_ads_lista, int tamanho) {
-    for (int i = 0; i < tamanho; i++) {
-        if (cursos_ads_lista[i] == codigo_curso) return 1; // Encontrado
+// Aloca os contadores zerados: num_blocos vezes o tamanho pedido pelo registro de perguntas.
+void resultados_criar(Resultados* resultados, int num_blocos) {
+    resultados->num_contadores = num_blocos * perguntas_num_contadores();
+    // Com zero blocos o calloc pode devolver NULL, que não é falta de memória: aloca ao menos um contador.
+    resultados->contadores = calloc(resultados->num_contadores > 0 ? (size_t)resultados->num_contadores : 1, sizeof(long long));
+    if (!resultados->contadores) {
+        fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
     }
-    return 0; // Não encontrado
 }
 
-// Função para verificar se um código de curso pertence à lista final de cursos de ADS
-int eh_curso_de_ads(int codigo_curso, const int* cursos_ads_lista, int qtd_cursos_ads) {
-    for (int i = 0; i < qtd_cursos_ads; i++) {
-        if (cursos_ads_lista[i] == codigo_curso) return 1;
+void resultados_liberar(Resultados* resultados) {
+    free(resultados->contadores);
+    resultados->contadores = NULL;
+}
+
+// Contadores privados de cada thread de um processo. Cada thread começa numa linha de cache própria
+// para que os incrementos de uma não invalidem a cache das outras (falso compartilhamento).
+typedef struct {
+    long long* contadores;
+    int num_threads;
+    int num_contadores;
+    size_t passo; // distância, em contadores, entre o bloco de uma thread e o da seguinte
+} ResultadosPorThread;
+
+void resultados_por_thread_criar(ResultadosPorThread* por_thread, int num_threads, int num_contadores) {
+    const size_t contadores_por_linha = TAMANHO_LINHA_DE_CACHE / sizeof(long long);
+    por_thread->num_threads = num_threads;
+    por_thread->num_contadores = num_contadores;
+    por_thread->passo = ((size_t)num_contadores + contadores_por_linha - 1) / contadores_por_linha * contadores_por_linha;
+    size_t bytes = (size_t)num_threads * por_thread->passo * sizeof(long long);
+    por_thread->contadores = aligned_alloc(TAMANHO_LINHA_DE_CACHE, bytes > 0 ? bytes : TAMANHO_LINHA_DE_CACHE);
+    if (!por_thread->contadores) {
+        fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
     }
-    return 0;
+    memset(por_thread->contadores, 0, bytes);
 }
 
-// Processa um único arquivo de dados e atualiza os contadores locais
-void processar_arquivo_de_dados(const char* nome_arquivo, int rank_processo, int num_processos, const int* cursos_ads_lista, int qtd_cursos_ads, Resultados* resultados_locais) {
-    FILE* arquivo = fopen(nome_arquivo, "r");
-    if (!arquivo) {
+// Visão dos contadores de uma thread com a mesma interface dos contadores do processo.
+Resultados resultados_da_thread(const ResultadosPorThread* por_thread, int thread) {
+    Resultados resultados = { por_thread->contadores + (size_t)thread * por_thread->passo, por_thread->num_contadores };
+    return resultados;
+}
+
+// Soma os contadores de todas as threads nos contadores do processo e libera os blocos.
+void resultados_por_thread_juntar(ResultadosPorThread* por_thread, Resultados* destino) {
+    for (int t = 0; t < por_thread->num_threads; t++) {
+        const long long* origem = por_thread->contadores + (size_t)t * por_thread->passo;
+        for (int i = 0; i < destino->num_contadores; i++) destino->contadores[i] += origem[i];
+    }
+    free(por_thread->contadores);
+    por_thread->contadores = NULL;
+}
+
+// Função para verificar se um código de curso pertence ao conjunto final de cursos de ADS
+static inline int eh_curso_de_ads(int codigo_curso, const IndiceCursos* cursos_ads) {
+    return indice_cursos_contem(cursos_ads, codigo_curso);
+}
+
+// Quais linhas são contadas e em qual bloco de contadores: no modo normal só os cursos de ADS, todos no bloco 0;
+// no modo por grupo todo curso do arq1 conta, no bloco do seu CO_GRUPO.
+typedef struct {
+    const IndiceCursos* cursos_ads;
+    const MapaGrupos* grupos; // NULL fora do modo por grupo
+    int contadores_por_bloco;
+} SelecaoDeCursos;
+
+// Bloco de contadores de uma linha, ou -1 se ela não entra na análise.
+static inline int bloco_do_curso(int codigo_curso, const SelecaoDeCursos* selecao) {
+    if (selecao->grupos) return mapa_grupos_bloco(selecao->grupos, codigo_curso);
+    return eh_curso_de_ads(codigo_curso, selecao->cursos_ads) ? 0 : -1;
+}
+
+// Aplica uma linha já lida de um arquivo de dados aos contadores locais
+static inline void contar_registro(const TabelaDespacho* despacho, int codigo_curso, char resposta, const SelecaoDeCursos* selecao, Resultados* resultados_locais) {
+    int bloco = bloco_do_curso(codigo_curso, selecao);
+    if (bloco >= 0) { //checa se o código lido pertence a um curso da análise
+        long long* contadores = resultados_locais->contadores + (size_t)bloco * selecao->contadores_por_bloco;
+        unsigned char byte = (unsigned char)resposta;
+        for (int i = 0; i < despacho->quantidade[byte]; i++) contadores[despacho->contadores[byte][i]]++;
+    }
+}
+
+// Aplica um lote de linhas já separado em colunas (o cache colunar ou um lote do parser).
+static void contar_colunas(const TabelaDespacho* despacho, const int32_t* codigos_curso, const uint8_t* respostas, long long num_linhas, const SelecaoDeCursos* selecao, Resultados* resultados_locais) {
+    for (long long i = 0; i < num_linhas; i++) contar_registro(despacho, codigos_curso[i], (char)respostas[i], selecao, resultados_locais);
+}
+
+// Aborta se o leitor terminou por falta de memória ou por dados compactados corrompidos.
+static void conferir_leitor(const LeitorDeLinhas* leitor) {
+    if (leitor->erro) {
+        fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (leitor->erro_dados) {
+        fprintf(stderr, "Erro fatal: dados compactados corrompidos ou truncados.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+}
+
+// Modo intercalado: todos os processos leem o arquivo inteiro e cada um fica com uma linha a cada num_processos.
+void processar_arquivo_intercalado(const char* nome_arquivo, const TabelaDespacho* despacho, ModoParser modo_parser, int rank_processo, int num_processos, const SelecaoDeCursos* selecao, Resultados* resultados_locais, MetricasArquivo* metricas) {
+    int descritor = open(nome_arquivo, O_RDONLY);
+    if (descritor < 0) {
         if (rank_processo == 0) fprintf(stderr, "Aviso: Não foi possível abrir %s.\n", nome_arquivo);
         return;
     }
+    LeitorDeLinhas leitor;
+    if (!leitor_iniciar(&leitor, descritor, 0, LEITOR_SEM_LIMITE)) {
+        fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    long long numero_linha = -1; // a linha -1 é o cabeçalho
+    const char *bloco, *fim_bloco;
+    off_t offset_bloco;
+    while (leitor_proximo_bloco(&leitor, &bloco, &fim_bloco, &offset_bloco)) {
+        double inicio_bloco = metricas_agora();
+        long long linhas_no_bloco = 0;
+        for (const char* linha = bloco; linha < fim_bloco; numero_linha++) {
+            if (numero_linha < 0 || numero_linha % num_processos != rank_processo) { //divida trabalho entre processos igualmente por tamanho de linha
+                const char* quebra = memchr(linha, '\n', (size_t)(fim_bloco - linha));
+                linha = quebra ? quebra + 1 : fim_bloco;
+                continue;
+            }
+            RegistroDados registro;
+            linha = parser_linha_dados(linha, fim_bloco, modo_parser, &registro); // lê as 3 colunas de cada arquivo que abrir
+            contar_registro(despacho, registro.codigo_curso, registro.resposta, selecao, resultados_locais);
+            linhas_no_bloco++;
+        }
+        // Parse e contagem se alternam a cada linha: o tempo do bloco todo entra como parse.
+        metricas->parse += metricas_agora() - inicio_bloco;
+        metricas->linhas += linhas_no_bloco;
+    }
+    conferir_leitor(&leitor);
+    metricas->leitura += leitor.tempo_leitura;
+    metricas->bytes += (double)leitor.bytes_lidos;
+    leitor_liberar(&leitor);
+    close(descritor);
+}
+
+// Conta as linhas entregues pelo leitor até a primeira que começa em 'fim' ou depois, descartando a primeira
+// (o cabeçalho ou o resto da linha anterior ao intervalo). As linhas são lidas em lotes para colunas e só
+// então contadas, para medir parse e contagem separadamente.
+static void processar_linhas(LeitorDeLinhas* leitor, off_t fim, const TabelaDespacho* despacho, ModoParser modo_parser, const SelecaoDeCursos* selecao, Resultados* resultados, MetricasArquivo* metricas) {
+    int32_t codigos_curso[LINHAS_POR_LOTE];
+    uint8_t respostas[LINHAS_POR_LOTE];
+    const char *bloco, *fim_bloco;
+    off_t offset_bloco;
+    int descartar_primeira_linha = 1;
+    while (leitor_proximo_bloco(leitor, &bloco, &fim_bloco, &offset_bloco)) {
+        const char* linha = bloco;
+        if (descartar_primeira_linha) {
+            linha = memchr(bloco, '\n', (size_t)(fim_bloco - bloco));
+            linha = linha ? linha + 1 : fim_bloco;
+            descartar_primeira_linha = 0;
+        }
+        while (linha < fim_bloco && offset_bloco + (linha - bloco) < fim) {
+            double inicio_lote = metricas_agora();
+            int num_linhas = 0;
+            while (num_linhas < LINHAS_POR_LOTE && linha < fim_bloco && offset_bloco + (linha - bloco) < fim) {
+                RegistroDados registro;
+                linha = parser_linha_dados(linha, fim_bloco, modo_parser, &registro);
+                codigos_curso[num_linhas] = registro.codigo_curso;
+                respostas[num_linhas] = (uint8_t)registro.resposta;
+                num_linhas++;
+            }
+            double fim_parse = metricas_agora();
+            contar_colunas(despacho, codigos_curso, respostas, num_linhas, selecao, resultados);
+            metricas->parse += fim_parse - inicio_lote;
+            metricas->contagem += metricas_agora() - fim_parse;
+            metricas->linhas += num_linhas;
+        }
+        if (linha < fim_bloco) break; // a próxima linha já é de outro intervalo
+    }
+    conferir_leitor(leitor);
+    metricas->leitura += leitor->tempo_leitura;
+    metricas->bytes += (double)leitor->bytes_lidos;
+}
+
+// Conta as linhas que começam dentro de [inicio, fim): avança até a primeira linha que começa no intervalo
+// e para na primeira que começa depois dele. O intervalo que começa em 0 descarta o cabeçalho.
+void processar_intervalo(int descritor, off_t inicio, off_t fim, const TabelaDespacho* despacho, ModoParser modo_parser, const SelecaoDeCursos* selecao, Resultados* resultados, MetricasArquivo* metricas) {
+    if (inicio >= fim) return;
+
+    // Os demais intervalos começam um byte antes e descartam o resto da linha anterior
+    // (se o intervalo começar exatamente numa linha, descarta só o '\n').
+    LeitorDeLinhas leitor;
+    if (!leitor_iniciar(&leitor, descritor, (inicio == 0) ? 0 : inicio - 1, fim)) {
+        fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    processar_linhas(&leitor, fim, despacho, modo_parser, selecao, resultados, metricas);
+    leitor_liberar(&leitor);
+}
+
+// Conta todas as linhas de um membro compactado, descompactado em fluxo (a thread leitora descompacta
+// o próximo bloco enquanto este é contado).
+void processar_membro_compactado(int descritor, const MembroCompactado* membro, const TabelaDespacho* despacho, ModoParser modo_parser, const SelecaoDeCursos* selecao, Resultados* resultados, MetricasArquivo* metricas) {
+    LeitorDeLinhas leitor;
+    if (!leitor_iniciar_compactado(&leitor, descritor, membro)) {
+        fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    processar_linhas(&leitor, SEM_FIM, despacho, modo_parser, selecao, resultados, metricas);
+    leitor_liberar(&leitor);
+}
+
+// Converte um .txt inteiro para o cache colunar. Retorna 0 se não conseguir ler ou gravar.
+int gerar_cache_do_arquivo(const char* nome_arquivo, ModoParser modo_parser) {
+    int descritor = open(nome_arquivo, O_RDONLY);
+    if (descritor < 0) return 0;
+    struct stat origem;
+    fstat(descritor, &origem); // antes da leitura: se o .txt mudar durante a conversão, o cache já nasce desatualizado
 
-    char linha[TAMANHO_MAX_LINHA];
-    long long numero_linha = 0; // saber a linha atual para poder dividir igualmente trabalho entre processos
-    fgets(linha, sizeof(linha), arquivo); // Pula cabeçalho
-
-    while (fgets(linha, sizeof(linha), arquivo)) {
-        if (numero_linha % num_processos == rank_processo) { //divida trabalho entre processos igualmente por tamanho de linha
-            int ano = 0, codigo_curso = 0;
-            char resposta_str[2] = {0};
-
-            sscanf(linha, "%d;%d;\"%1s\"", &ano, &codigo_curso, resposta_str); // lê as 3 colunas de cada arquivo que abrir
-            
-            if (eh_curso_de_ads(codigo_curso, cursos_ads_lista, qtd_cursos_ads)) { //checa se o código lido é igual a um código na lista ADS
-                if (strcmp(nome_arquivo, "DADOS/microdados2021_arq5.txt") == 0) {
-                    resultados_locais->total_alunos++;
-                    if (resposta_str[0] == 'F') resultados_locais->alunas_sexo_feminino++;
-                } else if (strcmp(nome_arquivo, "DADOS/microdados2021_arq24.txt") == 0) {
-                    if (resposta_str[0] == 'B') resultados_locais->alunos_ensino_tecnico++;
-                } else if (strcmp(nome_arquivo, "DADOS/microdados2021_arq21.txt") == 0) {
-                    if (resposta_str[0] != 'A' && resposta_str[0] != ' ' && resposta_str[0] != '.') resultados_locais->total_acao_afirmativa++;
-                } else if (strcmp(nome_arquivo, "DADOS/microdados2021_arq25.txt") == 0) {
-                    switch (resposta_str[0]) {
-                        case 'A': resultados_locais->incentivo_nenhum++; break; case 'B': resultados_locais->incentivo_pais++; break;
-                        case 'C': resultados_locais->incentivo_familia++; break; case 'D': resultados_locais->incentivo_professores++; break;
-                        case 'E': resultados_locais->incentivo_lider_religioso++; break; case 'F': resultados_locais->incentivo_amigos++; break;
-                        case 'G': resultados_locais->incentivo_outros++; break; default: resultados_locais->incentivo_nulo++; break;
-                    }
-                } else if (strcmp(nome_arquivo, "DADOS/microdados2021_arq27.txt") == 0) {
-                    switch (resposta_str[0]) {
-                        case 'A': resultados_locais->familia_graduada_sim++; break; case 'B': resultados_locais->familia_graduada_nao++; break;
-                        default: resultados_locais->familia_graduada_nulo++; break;
-                    }
-                } else if (strcmp(nome_arquivo, "DADOS/microdados2021_arq28.txt") == 0) {
-                    switch (resposta_str[0]) {
-                        case 'A': resultados_locais->livros_nenhum++; break; case 'B': resultados_locais->livros_um_a_dois++; break;
-                        case 'C': resultados_locais->livros_tres_a_cinco++; break; case 'D': resultados_locais->livros_seis_a_oito++; break;
-                        case 'E': resultados_locais->livros_mais_de_oito++; break; default: resultados_locais->livros_nulo++; break;
-                    }
-                } else if (strcmp(nome_arquivo, "DADOS/microdados2021_arq29.txt") == 0) {
-                    switch (resposta_str[0]) {
-                        case 'A': resultados_locais->horas_estudo_nenhuma++; break; case 'B': resultados_locais->horas_estudo_uma_a_tres++; break;
-                        case 'C': resultados_locais->horas_estudo_quatro_a_sete++; break; case 'D': resultados_locais->horas_estudo_oito_a_doze++; break;
-                        case 'E': resultados_locais->horas_estudo_mais_de_doze++; break; default: resultados_locais->horas_estudo_nulo++; break;
-                    }
+    LeitorDeLinhas leitor;
+    uint64_t num_linhas = 0, capacidade = 0;
+    int32_t* codigos_curso = NULL;
+    uint8_t* respostas = NULL;
+    int ok = leitor_iniciar(&leitor, descritor, 0, LEITOR_SEM_LIMITE);
+
+    const char *bloco, *fim_bloco;
+    off_t offset_bloco;
+    int descartar_cabecalho = 1;
+    while (ok && leitor_proximo_bloco(&leitor, &bloco, &fim_bloco, &offset_bloco)) {
+        const char* linha = bloco;
+        if (descartar_cabecalho) {
+            linha = memchr(bloco, '\n', (size_t)(fim_bloco - bloco));
+            linha = linha ? linha + 1 : fim_bloco;
+            descartar_cabecalho = 0;
+        }
+        while (ok && linha < fim_bloco) {
+            if (num_linhas == capacidade) {
+                capacidade = (capacidade == 0) ? (1 << 20) : capacidade * 2;
+                int32_t* novos_codigos = realloc(codigos_curso, capacidade * sizeof(int32_t));
+                if (novos_codigos) codigos_curso = novos_codigos;
+                uint8_t* novas_respostas = realloc(respostas, capacidade * sizeof(uint8_t));
+                if (novas_respostas) respostas = novas_respostas;
+                ok = novos_codigos && novas_respostas;
+                if (!ok) break;
+            }
+            RegistroDados registro;
+            linha = parser_linha_dados(linha, fim_bloco, modo_parser, &registro);
+            codigos_curso[num_linhas] = registro.codigo_curso;
+            respostas[num_linhas] = (uint8_t)registro.resposta;
+            num_linhas++;
+        }
+    }
+    close(descritor);
+
+    ok = ok && !leitor.erro && cache_gravar(nome_arquivo, &origem, codigos_curso, respostas, num_linhas);
+    leitor_liberar(&leitor);
+    free(codigos_curso);
+    free(respostas);
+    return ok;
+}
+
+// Um arquivo de dados pronto para ser processado em fatias: pelo cache colunar (fatias de linhas)
+// ou pelo texto (fatias de bytes).
+typedef struct {
+    const char* nome;
+    TabelaDespacho despacho; // resolvido uma vez por arquivo, não por linha
+    int usa_cache;
+    CacheColunar cache;
+    int compactado;          // lido de um membro .zip/.gz: não pode ser dividido
+    MembroCompactado membro;
+    int descritor;           // -1 se o texto (ou o membro compactado) não pôde ser aberto
+    long long tamanho;       // linhas do cache, bytes do texto ou bytes compactados do membro
+} ArquivoDeDados;
+
+// Abre o membro compactado que substitui 'nome_arquivo': o de mesmo nome dentro do .zip (em qualquer pasta)
+// ou 'nome_arquivo'.gz. Retorna o descritor, ou -1 se não encontrar.
+int abrir_membro_compactado(const char* nome_arquivo, const Configuracao* config, MembroCompactado* membro) {
+    if (config->fonte == FONTE_ZIP) {
+        const char* barra = strrchr(nome_arquivo, '/');
+        int descritor = open(config->arquivo_zip, O_RDONLY);
+        if (descritor >= 0 && zip_encontrar_membro(descritor, barra ? barra + 1 : nome_arquivo, membro)) return descritor;
+        if (descritor >= 0) close(descritor);
+        return -1;
+    }
+    char caminho[TAMANHO_MAX_CAMINHO + 4];
+    snprintf(caminho, sizeof(caminho), "%s.gz", nome_arquivo);
+    int descritor = open(caminho, O_RDONLY);
+    if (descritor >= 0 && gz_membro(descritor, membro)) return descritor;
+    if (descritor >= 0) close(descritor);
+    return -1;
+}
+
+// Prepara um arquivo para o processamento. É coletiva: todos os processos precisam concordar se o cache será usado.
+void abrir_arquivo_de_dados(const char* nome_arquivo, const Configuracao* config, int rank_processo, ArquivoDeDados* arquivo, MetricasProcesso* metricas) {
+    memset(arquivo, 0, sizeof(*arquivo));
+    arquivo->nome = nome_arquivo;
+    arquivo->descritor = -1;
+    perguntas_montar_despacho(nome_arquivo, &arquivo->despacho);
+
+    if (config->fonte != FONTE_TEXTO) {
+        arquivo->compactado = 1;
+        arquivo->descritor = abrir_membro_compactado(nome_arquivo, config, &arquivo->membro);
+        if (arquivo->descritor < 0) {
+            if (rank_processo == 0) fprintf(stderr, "Aviso: Não foi possível abrir %s (%s).\n", nome_arquivo, config->fonte == FONTE_ZIP ? config->arquivo_zip : ".gz");
+            return;
+        }
+        arquivo->tamanho = arquivo->membro.tamanho_compactado;
+        return;
+    }
+
+    if (config->usar_cache) {
+        EstadoCache estado = cache_abrir(nome_arquivo, &arquivo->cache);
+
+        // Se algum processo não conseguir usar o cache, todos voltam para o texto.
+        int cache_valido_local = (estado == CACHE_OK), cache_valido = 0;
+        double inicio = MPI_Wtime();
+        MPI_Allreduce(&cache_valido_local, &cache_valido, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+        metricas->coletivas += MPI_Wtime() - inicio;
+        if (cache_valido) {
+            arquivo->usa_cache = 1;
+            arquivo->tamanho = (long long)arquivo->cache.num_linhas;
+            return;
+        }
+        cache_fechar(&arquivo->cache);
+        if (rank_processo == 0 && estado != CACHE_AUSENTE) {
+            fprintf(stderr, "Aviso: cache de %s %s; lendo o arquivo de texto.\n", nome_arquivo, cache_descricao_estado(estado));
+        }
+    }
+
+    arquivo->descritor = open(nome_arquivo, O_RDONLY);
+    if (arquivo->descritor < 0) {
+        if (rank_processo == 0) fprintf(stderr, "Aviso: Não foi possível abrir %s.\n", nome_arquivo);
+        return;
+    }
+    struct stat info;
+    fstat(arquivo->descritor, &info);
+    arquivo->tamanho = (long long)info.st_size;
+}
+
+void fechar_arquivo_de_dados(ArquivoDeDados* arquivo) {
+    if (arquivo->usa_cache) cache_fechar(&arquivo->cache);
+    if (arquivo->descritor >= 0) close(arquivo->descritor);
+    arquivo->descritor = -1;
+}
+
+// Processa a fatia [inicio, fim) do arquivo (linhas do cache ou bytes do texto), repartida entre as threads
+// do processo. No texto, cada linha fica com a fatia que contém o seu primeiro byte.
+void processar_fatia(const ArquivoDeDados* arquivo, long long inicio, long long fim, const Configuracao* config, const SelecaoDeCursos* selecao, Resultados* resultados_locais, MetricasArquivo* metricas) {
+    if (inicio >= fim || (!arquivo->usa_cache && arquivo->descritor < 0)) return;
+    if (arquivo->compactado) { // o fluxo só pode ser lido do começo: fica inteiro com quem pegou o início
+        if (inicio == 0) processar_membro_compactado(arquivo->descritor, &arquivo->membro, &arquivo->despacho, config->modo_parser, selecao, resultados_locais, metricas);
+        return;
+    }
+
+    ResultadosPorThread por_thread;
+    resultados_por_thread_criar(&por_thread, config->num_threads, resultados_locais->num_contadores);
+    #pragma omp parallel num_threads(config->num_threads)
+    {
+        int thread = omp_get_thread_num();
+        long long inicio_thread = inicio + (fim - inicio) * thread / config->num_threads;
+        long long fim_thread = inicio + (fim - inicio) * (thread + 1) / config->num_threads;
+        Resultados resultados_thread = resultados_da_thread(&por_thread, thread);
+        MetricasArquivo metricas_thread = {0};
+
+        if (arquivo->usa_cache) {
+            double inicio_contagem = metricas_agora();
+            contar_colunas(&arquivo->despacho, arquivo->cache.codigos_curso + inicio_thread, arquivo->cache.respostas + inicio_thread,
+                           fim_thread - inicio_thread, selecao, &resultados_thread);
+            metricas_thread.contagem = metricas_agora() - inicio_contagem;
+            metricas_thread.linhas = (double)(fim_thread - inicio_thread);
+            metricas_thread.bytes = (double)(fim_thread - inicio_thread) * (sizeof(int32_t) + sizeof(uint8_t));
+        } else {
+            processar_intervalo(arquivo->descritor, (off_t)inicio_thread, (off_t)fim_thread, &arquivo->despacho, config->modo_parser, selecao, &resultados_thread, &metricas_thread);
+        }
+        #pragma omp critical
+        metricas_somar_arquivo(metricas, &metricas_thread);
+    }
+    resultados_por_thread_juntar(&por_thread, resultados_locais);
+}
+
+// Agendamento estático: arquivo por arquivo, cada processo fica com a sua fatia fixa e espera
+// os demais numa barreira antes do próximo arquivo.
+void processar_estatico(const char** arquivos_de_dados, int num_arquivos_de_dados, const Configuracao* config, int rank_processo, int num_processos, const SelecaoDeCursos* selecao, Resultados* resultados_locais, MetricasProcesso* metricas) {
+    for (int i = 0; i < num_arquivos_de_dados; ++i) { //fala qual arquivo esta analisando no momento
+        if (rank_processo == 0) printf("Analisando: %s...\n", arquivos_de_dados[i]);
+        ArquivoDeDados arquivo;
+        abrir_arquivo_de_dados(arquivos_de_dados[i], config, rank_processo, &arquivo, metricas);
+
+        double inicio = MPI_Wtime();
+        if (!arquivo.usa_cache && config->modo_leitura == LEITURA_INTERCALADA) {
+            processar_arquivo_intercalado(arquivo.nome, &arquivo.despacho, config->modo_parser, rank_processo, num_processos, selecao, resultados_locais, &metricas->arquivos[i]);
+        } else {
+            processar_fatia(&arquivo, arquivo.tamanho * rank_processo / num_processos, arquivo.tamanho * (rank_processo + 1) / num_processos,
+                            config, selecao, resultados_locais, &metricas->arquivos[i]);
+        }
+        metricas->trabalho += MPI_Wtime() - inicio;
+        metricas->chunks++;
+        fechar_arquivo_de_dados(&arquivo);
+
+        inicio = MPI_Wtime();
+        MPI_Barrier(MPI_COMM_WORLD); 
+        metricas->espera += MPI_Wtime() - inicio;
+    }
+}
+
+// Pedaço de um arquivo de dados distribuído pelo agendamento dinâmico.
+typedef struct {
+    int arquivo;
+    long long inicio, fim; // linhas do cache ou bytes do texto
+} Chunk;
+
+static int comparar_chunks(const void* a, const void* b) {
+    const Chunk* x = a;
+    const Chunk* y = b;
+    long long tamanho_x = x->fim - x->inicio, tamanho_y = y->fim - y->inicio;
+    if (tamanho_x != tamanho_y) return (tamanho_x > tamanho_y) ? -1 : 1; // maiores primeiro
+    if (x->arquivo != y->arquivo) return x->arquivo - y->arquivo;
+    return (x->inicio > y->inicio) - (x->inicio < y->inicio);
+}
+
+// Divide todos os arquivos em chunks de ~tamanho_chunk bytes (no cache, o número equivalente de linhas;
+// um membro compactado inteiro vira um chunk só), ordenados do maior para o menor para que as sobras menores fiquem para o fim. Todos os processos montam
+// a mesma lista.
+int montar_chunks(const ArquivoDeDados* arquivos, int num_arquivos, long long tamanho_chunk, Chunk** chunks) {
+    int num_chunks = 0;
+    for (int pass = 0; pass < 2; pass++) { // a primeira passada só conta
+        num_chunks = 0;
+        for (int i = 0; i < num_arquivos; i++) {
+            long long passo = arquivos[i].usa_cache ? tamanho_chunk / (long long)(sizeof(int32_t) + sizeof(uint8_t)) : tamanho_chunk;
+            if (arquivos[i].compactado) passo = arquivos[i].tamanho; // um chunk por membro
+            if (passo < 1) passo = 1;
+            if (!arquivos[i].usa_cache && arquivos[i].descritor < 0) continue;
+            for (long long inicio = 0; inicio < arquivos[i].tamanho; inicio += passo) {
+                if (pass == 1) {
+                    (*chunks)[num_chunks].arquivo = i;
+                    (*chunks)[num_chunks].inicio = inicio;
+                    (*chunks)[num_chunks].fim = (inicio + passo < arquivos[i].tamanho) ? inicio + passo : arquivos[i].tamanho;
                 }
+                num_chunks++;
             }
         }
-        numero_linha++;
+        if (pass == 0) {
+            *chunks = malloc((size_t)(num_chunks > 0 ? num_chunks : 1) * sizeof(Chunk));
+            if (!*chunks) {
+                fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+    }
+    qsort(*chunks, (size_t)num_chunks, sizeof(Chunk), comparar_chunks);
+    return num_chunks;
+}
+
+// Agendamento dinâmico: os sete arquivos são divididos em chunks de uma vez e cada processo pega o próximo
+// chunk livre com um fetch-and-add atômico (MPI_Fetch_and_op) num contador exposto pelo processo 0,
+// até acabarem os dados. Não há barreira entre arquivos; quem termina um chunk pesado não segura ninguém.
+void processar_dinamico(const char** arquivos_de_dados, int num_arquivos_de_dados, const Configuracao* config, int rank_processo, int num_processos, const SelecaoDeCursos* selecao, Resultados* resultados_locais, MetricasProcesso* metricas) {
+    ArquivoDeDados arquivos[NUM_MAX_ARQUIVOS];
+    for (int i = 0; i < num_arquivos_de_dados; i++) {
+        if (rank_processo == 0) printf("Preparando: %s...\n", arquivos_de_dados[i]);
+        abrir_arquivo_de_dados(arquivos_de_dados[i], config, rank_processo, &arquivos[i], metricas);
+    }
+
+    Chunk* chunks;
+    int num_chunks = montar_chunks(arquivos, num_arquivos_de_dados, config->tamanho_chunk, &chunks);
+    if (rank_processo == 0) printf("Distribuindo %d chunks dinamicamente entre os processos...\n", num_chunks);
+
+    // Com um único processo não há com quem disputar os chunks e a janela RMA seria só custo.
+    int usa_janela = (num_processos > 1);
+    long long proximo_chunk = 0; // só o do processo 0 é exposto na janela
+    MPI_Win janela;
+    if (usa_janela) {
+        double inicio_janela = MPI_Wtime();
+        MPI_Win_create(&proximo_chunk, (rank_processo == 0) ? sizeof(long long) : 0, sizeof(long long), MPI_INFO_NULL, MPI_COMM_WORLD, &janela);
+        MPI_Win_lock_all(0, janela);
+        metricas->coletivas += MPI_Wtime() - inicio_janela;
+    }
+
+    const long long um = 1;
+    double inicio = MPI_Wtime();
+    for (;;) {
+        long long indice;
+        if (usa_janela) {
+            double inicio_busca = MPI_Wtime();
+            MPI_Fetch_and_op(&um, &indice, MPI_LONG_LONG, 0, 0, MPI_SUM, janela);
+            MPI_Win_flush(0, janela);
+            metricas->coletivas += MPI_Wtime() - inicio_busca;
+        } else {
+            indice = proximo_chunk++;
+        }
+        if (indice >= num_chunks) break;
+
+        const Chunk* chunk = &chunks[indice];
+        processar_fatia(&arquivos[chunk->arquivo], chunk->inicio, chunk->fim, config, selecao, resultados_locais, &metricas->arquivos[chunk->arquivo]);
+        metricas->chunks++;
+    }
+    metricas->trabalho += MPI_Wtime() - inicio;
+
+    if (usa_janela) {
+        MPI_Win_unlock_all(janela);
+        MPI_Win_free(&janela);
     }
-    fclose(arquivo);
+    free(chunks);
+    for (int i = 0; i < num_arquivos_de_dados; i++) fechar_arquivo_de_dados(&arquivos[i]);
+}
+
+// Soma os contadores das letras listadas de uma pergunta (as respostas válidas).
+long long total_das_letras(const Resultados* resultados, int pergunta) {
+    long long total = 0;
+    for (int i = perguntas_primeiro_contador(pergunta); i < perguntas_contador_outras(pergunta); i++) total += resultados->contadores[i];
+    return total;
+}
+
+// Rótulo curto de uma categoria para as linhas e colunas da tabela cruzada.
+static const char* letra_da_categoria(int categoria, char* destino) {
+    if (categoria == CATEGORIA_NULAS) return "Nulas";
+    destino[0] = (char)('A' + categoria);
+    destino[1] = '\0';
+    return destino;
 }
 
-// Função de impressão dos resultados finais
-void imprimir_resultados_finais(int qtd_cursos_ads, const Resultados* resultados_finais) {
+// Tabela cruzada: legenda de cada arquivo, a matriz (com % da linha) quando são dois arquivos
+// e a lista das combinações encontradas quando são mais.
+void imprimir_tabela_cruzada(const EspecificacaoCruzamento* cruzamento, const TabelaCruzada* tabela) {
+    int num_dimensoes = tabela->num_dimensoes;
+    char nomes[MAX_DIMENSOES_CRUZAMENTO][64];
+    for (int d = 0; d < num_dimensoes; d++) cruzamento_nome_curto(cruzamento->arquivos[d], nomes[d], sizeof(nomes[d]));
+
+    printf("CRUZAMENTO:");
+    for (int d = 0; d < num_dimensoes; d++) printf("%s %s", d == 0 ? "" : " x", nomes[d]);
+    printf("\n- Estudantes de ADS cruzados: %lld\n", tabela->linhas_ads);
+    printf("- Linhas de ADS sem par no mesmo CO_CURSO dos outros arquivos:");
+    for (int d = 0; d < num_dimensoes; d++) printf("%s %s %lld", d == 0 ? "" : ",", nomes[d], tabela->linhas_sem_par[d]);
+    printf("\n");
+    printf("---------------------------------------------------\n\n");
+    if (tabela->linhas_ads == 0) {
+        printf("Nenhum estudante do curso de ADS foi encontrado nos dados para análise.\n");
+        return;
+    }
+
+    // Totais marginais: só as categorias que aparecem entram na legenda e na matriz.
+    long long marginais[MAX_DIMENSOES_CRUZAMENTO][NUM_CATEGORIAS_CRUZAMENTO] = {{0}};
+    for (long long celula = 0; celula < tabela->num_celulas; celula++) {
+        if (tabela->celulas[celula] == 0) continue;
+        long long resto = celula;
+        for (int d = num_dimensoes - 1; d >= 0; d--) {
+            marginais[d][resto % NUM_CATEGORIAS_CRUZAMENTO] += tabela->celulas[celula];
+            resto /= NUM_CATEGORIAS_CRUZAMENTO;
+        }
+    }
+
+    char letra[2], rotulo[128];
+    for (int d = 0; d < num_dimensoes; d++) {
+        printf("%s:\n", nomes[d]);
+        for (int c = 0; c < NUM_CATEGORIAS_CRUZAMENTO; c++) {
+            if (marginais[d][c] == 0) continue;
+            cruzamento_rotulo(cruzamento->arquivos[d], c, rotulo, sizeof(rotulo));
+            const char* categoria = letra_da_categoria(c, letra);
+            printf("   - %s%s%s: %lld (%.2f%%)\n", categoria, strcmp(categoria, rotulo) ? " = " : "", strcmp(categoria, rotulo) ? rotulo : "",
+                   marginais[d][c], (double)marginais[d][c] * 100.0 / tabela->linhas_ads);
+        }
+        printf("\n");
+    }
+
+    if (num_dimensoes == 2) {
+        printf("%s (linhas) x %s (colunas), com %% da linha:\n", nomes[0], nomes[1]);
+        printf("   %-6s", "");
+        for (int c = 0; c < NUM_CATEGORIAS_CRUZAMENTO; c++) {
+            if (marginais[1][c]) printf(" %18s", letra_da_categoria(c, letra));
+        }
+        printf(" %10s\n", "Total");
+        for (int l = 0; l < NUM_CATEGORIAS_CRUZAMENTO; l++) {
+            if (marginais[0][l] == 0) continue;
+            printf("   %-6s", letra_da_categoria(l, letra));
+            for (int c = 0; c < NUM_CATEGORIAS_CRUZAMENTO; c++) {
+                if (marginais[1][c] == 0) continue;
+                long long contagem = tabela->celulas[l * NUM_CATEGORIAS_CRUZAMENTO + c];
+                printf(" %9lld (%5.1f%%)", contagem, (double)contagem * 100.0 / marginais[0][l]);
+            }
+            printf(" %10lld\n", marginais[0][l]);
+        }
+    } else {
+        printf("Combinações encontradas (%% do total):\n");
+        for (long long celula = 0; celula < tabela->num_celulas; celula++) {
+            if (tabela->celulas[celula] == 0) continue;
+            printf("  ");
+            long long divisor = tabela->num_celulas;
+            for (int d = 0; d < num_dimensoes; d++) {
+                divisor /= NUM_CATEGORIAS_CRUZAMENTO;
+                printf(" %s=%-5s", nomes[d], letra_da_categoria((int)(celula / divisor % NUM_CATEGORIAS_CRUZAMENTO), letra));
+            }
+            printf(" %lld (%.2f%%)\n", tabela->celulas[celula], (double)tabela->celulas[celula] * 100.0 / tabela->linhas_ads);
+        }
+    }
+}
+
+// Total de linhas contadas pela pergunta de contagem (a base dos percentuais), ou 0 se não houver.
+long long contagem_base(const Resultados* resultados) {
+    for (int p = 0; p < NUM_PERGUNTAS; p++) {
+        if (PERGUNTAS[p].tipo == PERGUNTA_CONTAGEM) return resultados->contadores[perguntas_contador_outras(p)];
+    }
+    return 0;
+}
+
+// Respostas de todas as perguntas do registro para um bloco de contadores.
+void imprimir_perguntas(const Resultados* resultados_finais, const char* descricao_cursos) {
+    long long contagem_base_total = contagem_base(resultados_finais); // para calcular porcentagens
+    if (contagem_base_total == 0) {
+        printf("Nenhum estudante %s foi encontrado nos dados para análise.\n", descricao_cursos);
+        return;
+    }
+
+    for (int p = 0; p < NUM_PERGUNTAS; p++) {
+        const Pergunta* pergunta = &PERGUNTAS[p];
+        const long long* contadores = resultados_finais->contadores + perguntas_primeiro_contador(p);
+        long long outras = resultados_finais->contadores[perguntas_contador_outras(p)];
+        int num_letras = (int)strlen(pergunta->letras);
+
+        printf("%d. %s\n", p + 1, pergunta->enunciado);
+        if (pergunta->tipo == PERGUNTA_CONTAGEM) {
+            printf("   Resposta: %lld estudantes. \n\n", outras);
+        } else if (pergunta->tipo == PERGUNTA_PROPORCAO) {
+            long long marcados = pergunta->conta_outras ? outras : total_das_letras(resultados_finais, p);
+            printf("   Resposta: %lld estudantes (%.2f%% do total).\n\n", marcados, (double)marcados * 100.0 / contagem_base_total);
+        } else {
+            long long total_valido = total_das_letras(resultados_finais, p);
+            if (total_valido > 0) {
+                for (int i = 0; i < num_letras; i++) {
+                    printf("   - %s%lld (%.2f%%)\n", pergunta->rotulos[i], contadores[i], (double)contadores[i] * 100.0 / total_valido);
+                }
+                printf("   - Respostas Nulas/Inválidas: %lld\n\n", outras);
+            } else { printf("   Nenhum dado encontrado para esta questão.\n\n"); }
+        }
+    }
+}
+
+// Função de impressão dos resultados finais. No modo de cruzamento recebe a tabela cruzada no lugar dos contadores das perguntas.
+void imprimir_resultados_finais(int qtd_cursos_ads, const Resultados* resultados_finais, const EspecificacaoCruzamento* cruzamento, const TabelaCruzada* tabela_cruzada) {
     printf("\n===================================================\n");
     printf("   Análise dos Microdados do ENADE para ADS\n");
     printf("===================================================\n\n");
@@ -111,173 +727,500 @@ void imprimir_resultados_finais(int qtd_cursos_ads, const Resultados* resultados
     printf("- Cursos de ADS (CO_GRUPO %d) capturados: %d\n", CODIGO_GRUPO_ADS, qtd_cursos_ads);
     printf("---------------------------------------------------\n\n");
 
-    if (resultados_finais->total_alunos == 0) {
-        printf("Nenhum estudante do curso de ADS foi encontrado nos dados para análise.\n");
+    if (tabela_cruzada) {
+        imprimir_tabela_cruzada(cruzamento, tabela_cruzada);
         return;
     }
-    long long contagem_base_total = resultados_finais->total_alunos; // para calcular porcentagens
+    imprimir_perguntas(resultados_finais, "do curso de ADS");
+}
 
-    printf("1. Qual é a quantidade de estudantes matriculados?\n");
-    printf("   Resposta: %lld estudantes. \n\n", resultados_finais->total_alunos);
+// Modo por grupo: o relatório das perguntas para cada CO_GRUPO que tem estudantes nos arquivos de dados.
+void imprimir_resultados_por_grupo(const MapaGrupos* grupos, const Resultados* resultados_finais) {
+    printf("\n===================================================\n");
+    printf("   Análise dos Microdados do ENADE por grupo de curso\n");
+    printf("===================================================\n\n");
 
+    printf("DETECÇÃO INICIAL:\n");
+    printf("- Grupos de curso (CO_GRUPO) encontrados: %d\n", grupos->num_grupos);
+    printf("- Cursos capturados: %d\n", grupos->quantidade);
+    printf("---------------------------------------------------\n");
 
-    printf("2. Qual é a porcentagem de estudante do sexo Feminino?\n");
-    double percentual_feminino = (contagem_base_total > 0) ? (double)resultados_finais->alunas_sexo_feminino * 100.0 / contagem_base_total : 0;
-    printf("   Resposta: %lld estudantes (%.2f%% do total).\n\n", resultados_finais->alunas_sexo_feminino, percentual_feminino);
+    int contadores_por_grupo = perguntas_num_contadores(), grupos_vazios = 0;
+    for (int g = 0; g < grupos->num_grupos; g++) {
+        Resultados grupo = { resultados_finais->contadores + (size_t)g * contadores_por_grupo, contadores_por_grupo };
+        if (contagem_base(&grupo) == 0) {
+            grupos_vazios++;
+            continue;
+        }
+        printf("\n===================================================\n");
+        printf("CO_GRUPO %d (%d cursos)\n", grupos->codigos_grupo[g], grupos->cursos_por_grupo[g]);
+        printf("---------------------------------------------------\n\n");
+        imprimir_perguntas(&grupo, "do grupo");
+    }
+    if (grupos_vazios > 0) printf("\nGrupos sem estudantes nos arquivos de dados: %d\n", grupos_vazios);
+}
 
-    printf("3. Qual é a porcentagem de estudantes que cursaram o ensino técnico no ensino médio?\n");
-    double percentual_ensino_tecnico = (contagem_base_total > 0) ? (double)resultados_finais->alunos_ensino_tecnico * 100.0 / contagem_base_total : 0;
-    printf("   Resposta: %lld estudantes (%.2f%% do total).\n\n", resultados_finais->alunos_ensino_tecnico, percentual_ensino_tecnico);
+// Lê as linhas do arq1 entregues pelo leitor até 'fim', com a mesma regra de posse de processar_linhas:
+// os cursos de ADS vão para 'cursos_ads' e, se 'grupos' não for NULL, todos os cursos vão para o mapa de grupos.
+static void ler_cursos(LeitorDeLinhas* leitor, off_t fim, ModoParser modo_parser, IndiceCursos* cursos_ads, MapaGrupos* grupos) {
+    const char *bloco, *fim_bloco;
+    off_t offset_bloco;
+    int descartar_primeira_linha = 1;
+    while (leitor_proximo_bloco(leitor, &bloco, &fim_bloco, &offset_bloco)) {
+        const char* linha = bloco;
+        if (descartar_primeira_linha) {
+            linha = memchr(bloco, '\n', (size_t)(fim_bloco - bloco));
+            linha = linha ? linha + 1 : fim_bloco;
+            descartar_primeira_linha = 0;
+        }
+        while (linha < fim_bloco && offset_bloco + (linha - bloco) < fim) {
+            RegistroArq1 registro;
+            linha = parser_linha_arq1(linha, fim_bloco, modo_parser, &registro);
+            if (registro.itens_lidos < 2) continue;
 
-    printf("4. Qual é o percentual de alunos provenientes de ações afirmativas?\n");
-    double percentual_acao_afirmativa = (contagem_base_total > 0) ? (double)resultados_finais->total_acao_afirmativa * 100.0 / contagem_base_total : 0;
-    printf("   Resposta: %lld estudantes (%.2f%% do total).\n\n", resultados_finais->total_acao_afirmativa, percentual_acao_afirmativa);
-    
-    printf("5. Dos estudantes, quem deu incentivo para este estudante cursar o ADS?\n");
-    long long total_incentivo_valido = resultados_finais->incentivo_pais + resultados_finais->incentivo_familia + resultados_finais->incentivo_professores + resultados_finais->incentivo_amigos + resultados_finais->incentivo_lider_religioso + resultados_finais->incentivo_outros + resultados_finais->incentivo_nenhum;
-    if (total_incentivo_valido > 0) {
-        printf("   - Pais:                 %lld (%.2f%%)\n", resultados_finais->incentivo_pais, (double)resultados_finais->incentivo_pais * 100.0 / total_incentivo_valido);
-        printf("   - Outros familiares:    %lld (%.2f%%)\n", resultados_finais->incentivo_familia, (double)resultados_finais->incentivo_familia * 100.0 / total_incentivo_valido);
-        printf("   - Professores:          %lld (%.2f%%)\n", resultados_finais->incentivo_professores, (double)resultados_finais->incentivo_professores * 100.0 / total_incentivo_valido);
-        printf("   - Colegas/Amigos:       %lld (%.2f%%)\n", resultados_finais->incentivo_amigos, (double)resultados_finais->incentivo_amigos * 100.0 / total_incentivo_valido);
-        printf("   - Líder religioso:      %lld (%.2f%%)\n", resultados_finais->incentivo_lider_religioso, (double)resultados_finais->incentivo_lider_religioso * 100.0 / total_incentivo_valido);
-        printf("   - Outras pessoas:       %lld (%.2f%%)\n", resultados_finais->incentivo_outros, (double)resultados_finais->incentivo_outros * 100.0 / total_incentivo_valido);
-        printf("   - Ninguém:              %lld (%.2f%%)\n", resultados_finais->incentivo_nenhum, (double)resultados_finais->incentivo_nenhum * 100.0 / total_incentivo_valido);
-        printf("   - Respostas Nulas/Inválidas: %lld\n\n", resultados_finais->incentivo_nulo);
-    } else { printf("   Nenhum dado encontrado para esta questão.\n\n"); }
-
-    printf("6. Quantos estudantes apresentaram familiares com o curso superior concluído?\n");
-    long long total_familia_valido = resultados_finais->familia_graduada_sim + resultados_finais->familia_graduada_nao;
-     if (total_familia_valido > 0) {
-        printf("   - Sim: %lld (%.2f%%)\n", resultados_finais->familia_graduada_sim, (double)resultados_finais->familia_graduada_sim * 100.0 / total_familia_valido);
-        printf("   - Não: %lld (%.2f%%)\n", resultados_finais->familia_graduada_nao, (double)resultados_finais->familia_graduada_nao * 100.0 / total_familia_valido);
-        printf("   - Respostas Nulas/Inválidas: %lld\n\n", resultados_finais->familia_graduada_nulo);
-    } else { printf("   Nenhum dado encontrado para esta questão.\n\n"); }
-
-    printf("7. Quantos livros os alunos leram no ano do ENADE?\n");
-    long long total_livros_valido = resultados_finais->livros_nenhum + resultados_finais->livros_um_a_dois + resultados_finais->livros_tres_a_cinco + resultados_finais->livros_seis_a_oito + resultados_finais->livros_mais_de_oito;
-    if (total_livros_valido > 0) {
-       printf("   - Nenhum:        %lld (%.2f%%)\n", resultados_finais->livros_nenhum, (double)resultados_finais->livros_nenhum * 100.0 / total_livros_valido);
-       printf("   - 1 ou 2:        %lld (%.2f%%)\n", resultados_finais->livros_um_a_dois, (double)resultados_finais->livros_um_a_dois * 100.0 / total_livros_valido);
-       printf("   - 3 a 5:         %lld (%.2f%%)\n", resultados_finais->livros_tres_a_cinco, (double)resultados_finais->livros_tres_a_cinco * 100.0 / total_livros_valido);
-       printf("   - 6 a 8:         %lld (%.2f%%)\n", resultados_finais->livros_seis_a_oito, (double)resultados_finais->livros_seis_a_oito * 100.0 / total_livros_valido);
-       printf("   - Mais de 8:     %lld (%.2f%%)\n", resultados_finais->livros_mais_de_oito, (double)resultados_finais->livros_mais_de_oito * 100.0 / total_livros_valido);
-       printf("   - Respostas Nulas/Inválidas: %lld\n\n", resultados_finais->livros_nulo);
-    } else { printf("   Nenhum dado encontrado para esta questão.\n\n"); }
-    
-    printf("8. Quantas horas na semana os estudantes se dedicaram aos estudos?\n");
-    long long total_estudo_valido = resultados_finais->horas_estudo_nenhuma + resultados_finais->horas_estudo_uma_a_tres + resultados_finais->horas_estudo_quatro_a_sete + resultados_finais->horas_estudo_oito_a_doze + resultados_finais->horas_estudo_mais_de_doze;
-    if (total_estudo_valido > 0) {
-        printf("   - Nenhuma (só aulas): %lld (%.2f%%)\n", resultados_finais->horas_estudo_nenhuma, (double)resultados_finais->horas_estudo_nenhuma * 100.0 / total_estudo_valido);
-        printf("   - 1 a 3 horas:        %lld (%.2f%%)\n", resultados_finais->horas_estudo_uma_a_tres, (double)resultados_finais->horas_estudo_uma_a_tres * 100.0 / total_estudo_valido);
-        printf("   - 4 a 7 horas:        %lld (%.2f%%)\n", resultados_finais->horas_estudo_quatro_a_sete, (double)resultados_finais->horas_estudo_quatro_a_sete * 100.0 / total_estudo_valido);
-        printf("   - 8 a 12 horas:       %lld (%.2f%%)\n", resultados_finais->horas_estudo_oito_a_doze, (double)resultados_finais->horas_estudo_oito_a_doze * 100.0 / total_estudo_valido);
-        printf("   - Mais de 12 horas:   %lld (%.2f%%)\n", resultados_finais->horas_estudo_mais_de_doze, (double)resultados_finais->horas_estudo_mais_de_doze * 100.0 / total_estudo_valido);
-        printf("   - Respostas Nulas/Inválidas: %lld\n\n", resultados_finais->horas_estudo_nulo);
-    } else { printf("   Nenhum dado encontrado para esta questão.\n\n"); }
+            if (grupos && mapa_grupos_inserir(grupos, registro.codigo_curso, registro.codigo_grupo) < 0) {
+                fprintf(stderr, "Erro fatal: falha ao alocar memória ou mais de %d grupos de curso.\n", MAX_GRUPOS);
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            // O índice ignora cursos repetidos sozinho.
+            if (registro.codigo_grupo == CODIGO_GRUPO_ADS && indice_cursos_inserir(cursos_ads, registro.codigo_curso) < 0) {
+                fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+        if (linha < fim_bloco) break; // a próxima linha já é de outro intervalo
+    }
+    conferir_leitor(leitor);
+}
+
+// Lê a parte do arq1 que cabe a este processo: o seu intervalo de bytes do texto ou, com a entrada compactada,
+// o membro inteiro no processo 0 (um fluxo deflate não pode ser dividido; os demais ficam com conjuntos vazios).
+void ler_arq1(const char* caminho_arq1, const Configuracao* config, int rank_processo, int num_processos, IndiceCursos* cursos_ads, MapaGrupos* grupos) {
+    LeitorDeLinhas leitor;
+    if (config->fonte != FONTE_TEXTO) {
+        if (rank_processo != 0) return;
+        MembroCompactado membro;
+        int descritor = abrir_membro_compactado(caminho_arq1, config, &membro);
+        if (descritor < 0) {
+            fprintf(stderr, "Erro fatal: não foi possível abrir '%s' (%s).\n", caminho_arq1, config->fonte == FONTE_ZIP ? config->arquivo_zip : ".gz");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (!leitor_iniciar_compactado(&leitor, descritor, &membro)) {
+            fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        ler_cursos(&leitor, SEM_FIM, config->modo_parser, cursos_ads, grupos);
+        leitor_liberar(&leitor);
+        close(descritor);
+        return;
+    }
+
+    int descritor = open(caminho_arq1, O_RDONLY);
+    struct stat info;
+    if (descritor < 0 || fstat(descritor, &info) != 0) {
+        fprintf(stderr, "Erro fatal: não foi possível abrir '%s'.\n", caminho_arq1);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    off_t inicio = (off_t)((long long)info.st_size * rank_processo / num_processos);
+    off_t fim = (off_t)((long long)info.st_size * (rank_processo + 1) / num_processos);
+    if (inicio < fim) {
+        if (!leitor_iniciar(&leitor, descritor, (inicio == 0) ? 0 : inicio - 1, fim)) {
+            fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        ler_cursos(&leitor, fim, config->modo_parser, cursos_ads, grupos);
+        leitor_liberar(&leitor);
+    }
+    close(descritor);
+}
+
+// Une os conjuntos locais de cursos de ADS, deixando o mesmo índice em todos os processos. Se os códigos couberem
+// num bitmap menor que a lista de todos eles, cada processo marca os seus num bitmap do tamanho global e um
+// MPI_Allreduce com MPI_BOR faz a união; senão as listas são trocadas com MPI_Allgatherv e cada processo monta o índice.
+void juntar_cursos_ads(IndiceCursos* cursos_ads, int num_processos) {
+    int resumo_local[3] = { cursos_ads->quantidade, cursos_ads->codigo_minimo, cursos_ads->codigo_maximo };
+    int* resumos = malloc((size_t)num_processos * 3 * sizeof(int));
+    int* quantidades = malloc((size_t)num_processos * sizeof(int));
+    int* deslocamentos = malloc((size_t)num_processos * sizeof(int));
+    if (!resumos || !quantidades || !deslocamentos) {
+        fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    MPI_Allgather(resumo_local, 3, MPI_INT, resumos, 3, MPI_INT, MPI_COMM_WORLD);
+
+    int total = 0, codigo_minimo = 0, codigo_maximo = 0;
+    for (int r = 0; r < num_processos; r++) {
+        quantidades[r] = resumos[3 * r];
+        deslocamentos[r] = total;
+        if (quantidades[r] == 0) continue;
+        if (total == 0 || resumos[3 * r + 1] < codigo_minimo) codigo_minimo = resumos[3 * r + 1];
+        if (total == 0 || resumos[3 * r + 2] > codigo_maximo) codigo_maximo = resumos[3 * r + 2];
+        total += quantidades[r];
+    }
+    free(resumos);
+
+    size_t palavras = (size_t)(uint32_t)codigo_maximo / 64 + 1;
+    int usa_bitmap = total > 0 && codigo_minimo >= 0 && palavras * sizeof(uint64_t) <= INDICE_LIMITE_BITMAP_BYTES &&
+                     palavras * sizeof(uint64_t) < (size_t)total * sizeof(int32_t);
+    if (usa_bitmap) {
+        if (!indice_cursos_para_bitmap(cursos_ads, palavras)) {
+            fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        MPI_Allreduce(MPI_IN_PLACE, cursos_ads->bitmap, (int)palavras, MPI_UINT64_T, MPI_BOR, MPI_COMM_WORLD);
+        indice_cursos_recontar(cursos_ads);
+        cursos_ads->codigo_minimo = codigo_minimo;
+        cursos_ads->codigo_maximo = codigo_maximo;
+    } else {
+        int32_t* locais = malloc((size_t)(cursos_ads->quantidade + 1) * sizeof(int32_t));
+        int32_t* todos = malloc((size_t)(total + 1) * sizeof(int32_t));
+        if (!locais || !todos) {
+            fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        int num_locais = indice_cursos_listar(cursos_ads, locais);
+        MPI_Allgatherv(locais, num_locais, MPI_INT32_T, todos, quantidades, deslocamentos, MPI_INT32_T, MPI_COMM_WORLD);
+
+        indice_cursos_liberar(cursos_ads);
+        indice_cursos_iniciar(cursos_ads);
+        for (int i = 0; i < total; i++) {
+            if (indice_cursos_inserir(cursos_ads, todos[i]) < 0) {
+                fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+        if (!indice_cursos_finalizar(cursos_ads, INDICE_AUTOMATICO)) {
+            fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        free(locais);
+        free(todos);
+    }
+    free(quantidades);
+    free(deslocamentos);
+}
+
+// Une os mapas CO_CURSO -> grupo locais trocando os pares com MPI_Allgatherv. Os pares chegam na ordem dos ranks,
+// que é a ordem do arquivo, então um curso listado em dois grupos fica com o primeiro, como na leitura serial.
+void juntar_mapa_grupos(MapaGrupos* grupos, int num_processos) {
+    int* quantidades = malloc((size_t)num_processos * sizeof(int));
+    int* deslocamentos = malloc((size_t)num_processos * sizeof(int));
+    int32_t* locais = malloc((size_t)(grupos->quantidade + 1) * 2 * sizeof(int32_t));
+    if (!quantidades || !deslocamentos || !locais) {
+        fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    int num_locais = 2 * mapa_grupos_listar(grupos, locais);
+    MPI_Allgather(&num_locais, 1, MPI_INT, quantidades, 1, MPI_INT, MPI_COMM_WORLD);
+    int total = 0;
+    for (int r = 0; r < num_processos; r++) {
+        deslocamentos[r] = total;
+        total += quantidades[r];
+    }
+    int32_t* todos = malloc((size_t)(total + 1) * sizeof(int32_t));
+    if (!todos) {
+        fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    MPI_Allgatherv(locais, num_locais, MPI_INT32_T, todos, quantidades, deslocamentos, MPI_INT32_T, MPI_COMM_WORLD);
+
+    mapa_grupos_liberar(grupos);
+    mapa_grupos_iniciar(grupos);
+    for (int i = 0; i < total; i += 2) {
+        if (mapa_grupos_inserir(grupos, todos[i], todos[i + 1]) < 0) {
+            fprintf(stderr, "Erro fatal: falha ao alocar memória ou mais de %d grupos de curso.\n", MAX_GRUPOS);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    if (!mapa_grupos_finalizar(grupos)) {
+        fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    free(quantidades);
+    free(deslocamentos);
+    free(locais);
+    free(todos);
+}
+
+// Lê as opções da linha de comando. Retorna 0 se alguma opção for inválida.
+int ler_argumentos(int argc, char** argv, Configuracao* config) {
+    config->modo_leitura = LEITURA_PARTICIONADA;
+    config->modo_parser = PARSER_SIMD;
+    config->usar_cache = 1;
+    config->gerar_cache = 0;
+    // Uma thread por processo, a não ser que OMP_NUM_THREADS peça mais: com um processo por núcleo
+    // (mpiexec -n <núcleos>), usar todos os núcleos em cada processo sobrecarregaria o nó.
+    config->num_threads = getenv("OMP_NUM_THREADS") ? omp_get_max_threads() : 1;
+    config->agendamento = AGENDAMENTO_DINAMICO;
+    config->tamanho_chunk = (long long)TAMANHO_CHUNK_PADRAO_MB << 20;
+    config->tamanho_bloco = TAMANHO_BLOCO_LEITURA_PADRAO;
+    config->num_buffers = NUM_BUFFERS_LEITURA_PADRAO;
+    config->cruzamento.num_dimensoes = 0;
+    config->por_grupo = 0;
+    config->arquivo_csv = NULL;
+    config->arquivo_json = NULL;
+    config->arquivo_metricas = NULL;
+    config->fonte = FONTE_TEXTO;
+    config->arquivo_zip = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--leitura=particionada") == 0) {
+            config->modo_leitura = LEITURA_PARTICIONADA;
+        } else if (strcmp(argv[i], "--leitura=intercalada") == 0) {
+            config->modo_leitura = LEITURA_INTERCALADA;
+        } else if (strcmp(argv[i], "--parser=simd") == 0) {
+            config->modo_parser = PARSER_SIMD;
+        } else if (strcmp(argv[i], "--parser=escalar") == 0) {
+            config->modo_parser = PARSER_ESCALAR;
+        } else if (strcmp(argv[i], "--parser=sscanf") == 0) {
+            config->modo_parser = PARSER_SSCANF;
+        } else if (strcmp(argv[i], "--gerar-cache") == 0) {
+            config->gerar_cache = 1;
+        } else if (strcmp(argv[i], "--sem-cache") == 0) {
+            config->usar_cache = 0;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            config->num_threads = atoi(argv[i] + 10);
+            if (config->num_threads < 1) return 0;
+        } else if (strcmp(argv[i], "--agendamento=estatico") == 0) {
+            config->agendamento = AGENDAMENTO_ESTATICO;
+        } else if (strcmp(argv[i], "--agendamento=dinamico") == 0) {
+            config->agendamento = AGENDAMENTO_DINAMICO;
+        } else if (strncmp(argv[i], "--cruzar=", 9) == 0) {
+            if (!cruzamento_ler_especificacao(argv[i] + 9, &config->cruzamento)) return 0;
+        } else if (strcmp(argv[i], "--por-grupo") == 0) {
+            config->por_grupo = 1;
+        } else if (strncmp(argv[i], "--csv=", 6) == 0) {
+            config->arquivo_csv = argv[i] + 6;
+        } else if (strncmp(argv[i], "--json=", 7) == 0) {
+            config->arquivo_json = argv[i] + 7;
+        } else if (strncmp(argv[i], "--metricas-json=", 16) == 0) {
+            config->arquivo_metricas = argv[i] + 16;
+        } else if (strncmp(argv[i], "--zip=", 6) == 0) {
+            config->fonte = FONTE_ZIP;
+            config->arquivo_zip = argv[i] + 6;
+        } else if (strcmp(argv[i], "--gz") == 0) {
+            config->fonte = FONTE_GZ;
+        } else if (strncmp(argv[i], "--chunk-mb=", 11) == 0) {
+            config->tamanho_chunk = (long long)atoi(argv[i] + 11) << 20;
+            if (config->tamanho_chunk < 1) return 0;
+        } else if (strncmp(argv[i], "--bloco-mb=", 11) == 0) {
+            config->tamanho_bloco = (long long)atoi(argv[i] + 11) << 20;
+            if (config->tamanho_bloco < 1) return 0;
+        } else if (strncmp(argv[i], "--buffers=", 10) == 0) {
+            config->num_buffers = atoi(argv[i] + 10);
+            if (config->num_buffers < 1) return 0;
+        } else {
+            return 0;
+        }
+    }
+    // A tabela cruzada não usa os contadores das perguntas.
+    if (config->cruzamento.num_dimensoes > 0 && (config->por_grupo || config->arquivo_csv || config->arquivo_json)) return 0;
+    // Os fluxos compactados só podem ser lidos do começo ao fim, por um leitor só.
+    if (config->fonte != FONTE_TEXTO && (config->cruzamento.num_dimensoes > 0 || config->gerar_cache || config->modo_leitura == LEITURA_INTERCALADA)) return 0;
+    return 1;
+}
+
+void imprimir_uso(const char* programa) {
+    fprintf(stderr, "Uso: mpiexec -n <processos> %s [opções]\n", programa);
+    fprintf(stderr, "  --leitura=particionada  cada processo lê só o seu intervalo de bytes de cada arquivo (padrão)\n");
+    fprintf(stderr, "  --leitura=intercalada   todos leem o arquivo inteiro e dividem as linhas por rank\n");
+    fprintf(stderr, "  --parser=simd           separa os campos com SSE2/AVX2 (padrão)\n");
+    fprintf(stderr, "  --parser=escalar        mesmo parser, byte a byte\n");
+    fprintf(stderr, "  --parser=sscanf         parser original com sscanf, para comparação\n");
+    fprintf(stderr, "  --gerar-cache           converte cada arquivo de dados para o cache colunar (.col) antes da análise\n");
+    fprintf(stderr, "  --sem-cache             ignora o cache colunar e lê sempre os arquivos de texto\n");
+    fprintf(stderr, "  --threads=N             threads por processo (padrão: OMP_NUM_THREADS ou 1)\n");
+    fprintf(stderr, "  --agendamento=dinamico  divide todos os arquivos em chunks distribuídos sob demanda (padrão)\n");
+    fprintf(stderr, "  --agendamento=estatico  um arquivo por vez, fatia fixa por processo e barreira entre arquivos\n");
+    fprintf(stderr, "  --chunk-mb=N            tamanho dos chunks do agendamento dinâmico (padrão: %d MB)\n", TAMANHO_CHUNK_PADRAO_MB);
+    fprintf(stderr, "  --bloco-mb=N            tamanho de cada leitura do disco (padrão: %d MB)\n", TAMANHO_BLOCO_LEITURA_PADRAO >> 20);
+    fprintf(stderr, "  --buffers=N             buffers em rodízio por leitor; com 2 ou mais, uma thread lê o próximo bloco\n");
+    fprintf(stderr, "                          enquanto o atual é processado; 1 lê de forma síncrona (padrão: %d)\n", NUM_BUFFERS_LEITURA_PADRAO);
+    fprintf(stderr, "  --por-grupo             responde as perguntas para cada CO_GRUPO numa única passada, não só ADS\n");
+    fprintf(stderr, "  --csv=ARQUIVO           grava as contagens das perguntas em CSV\n");
+    fprintf(stderr, "  --json=ARQUIVO          grava as contagens das perguntas em JSON\n");
+    fprintf(stderr, "  --metricas-json=ARQUIVO grava as métricas de tempo, bytes e linhas de cada processo em JSON\n");
+    fprintf(stderr, "  --zip=ARQUIVO           lê os arquivos de dados direto do .zip do INEP, sem descompactar em disco\n");
+    fprintf(stderr, "  --gz                    lê DADOS/<arquivo>.txt.gz em vez do .txt\n");
+    fprintf(stderr, "  --cruzar=arq5,arq29     tabela cruzada entre as respostas de 2 a %d arquivos, no lugar das perguntas\n", MAX_DIMENSOES_CRUZAMENTO);
 }
 
 int main(int argc, char** argv) {
-    MPI_Init(&argc, &argv);
+    // Só a thread principal chama o MPI; as threads OpenMP apenas leem e contam.
+    int suporte_threads;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &suporte_threads);
 
     int num_processos, rank_processo;
     MPI_Comm_size(MPI_COMM_WORLD, &num_processos);
     MPI_Comm_rank(MPI_COMM_WORLD, &rank_processo);
+
+    Configuracao config;
+    if (!ler_argumentos(argc, argv, &config)) {
+        if (rank_processo == 0) imprimir_uso(argv[0]);
+        MPI_Finalize();
+        return 1;
+    }
+#ifndef _OPENMP
+    config.num_threads = 1; // compilado sem -fopenmp
+#endif
+    if (suporte_threads < MPI_THREAD_FUNNELED) config.num_threads = 1;
+    if (config.modo_leitura == LEITURA_INTERCALADA) config.agendamento = AGENDAMENTO_ESTATICO; // todos leem tudo: não há o que distribuir
+    if (config.fonte != FONTE_TEXTO) { // cada membro compactado é um chunk indivisível, distribuído sob demanda
+        config.usar_cache = 0;
+        config.agendamento = AGENDAMENTO_DINAMICO;
+    }
+    leitor_configurar((size_t)config.tamanho_bloco, config.num_buffers);
     
     double tempo_inicio;
 
     if (rank_processo == 0) {
-        printf("Análise iniciada com %d processos.\n", num_processos);
+        printf("Análise iniciada com %d processos e %d threads por processo.\n", num_processos, config.num_threads);
+        printf("Modo de leitura: %s. Parser: %s", config.modo_leitura == LEITURA_INTERCALADA ? "intercalada" : "particionada",
+               parser_nome_modo(config.modo_parser));
+        if (config.modo_parser == PARSER_SIMD) printf(" (%s)", parser_instrucoes_simd());
+        printf(". Agendamento: %s.\n", config.agendamento == AGENDAMENTO_DINAMICO ? "dinâmico" : "estático");
+        if (config.fonte == FONTE_ZIP) printf("Entrada: membros de '%s', descompactados em fluxo.\n", config.arquivo_zip);
+        if (config.fonte == FONTE_GZ) printf("Entrada: arquivos .gz, descompactados em fluxo.\n");
+        printf("Leitura em blocos de %lld MB com %d buffer%s%s.\n", config.tamanho_bloco >> 20, config.num_buffers,
+               config.num_buffers > 1 ? "s" : "", config.num_buffers > 1 ? " (thread leitora em segundo plano)" : "");
         tempo_inicio = MPI_Wtime();
     }
     
-    int qtd_cursos_ads = 0;
-    int* cursos_ads_lista = NULL; 
+    IndiceCursos cursos_ads;
+    indice_cursos_iniciar(&cursos_ads);
+    MapaGrupos grupos; // só é preenchido no modo por grupo
+    mapa_grupos_iniciar(&grupos);
+    MetricasProcesso metricas = {0};
+
+    // Cada processo lê o seu intervalo de bytes do arq1 (compactado, só o processo 0 o lê) e monta os conjuntos
+    // locais; depois eles são unidos.
+    const char* caminho_arq1 = "DADOS/microdados2021_arq1.txt";
+    if (rank_processo == 0 && config.fonte == FONTE_TEXTO) printf("Lendo a lista de cursos de ADS de '%s' em %d processos...\n", caminho_arq1, num_processos);
+    if (rank_processo == 0 && config.fonte != FONTE_TEXTO) printf("Lendo a lista de cursos de ADS de '%s' (compactado)...\n", caminho_arq1);
+    double inicio_carga = MPI_Wtime();
+    ler_arq1(caminho_arq1, &config, rank_processo, num_processos, &cursos_ads, config.por_grupo ? &grupos : NULL);
+    metricas.carga_arq1 = MPI_Wtime() - inicio_carga;
+
+    double inicio_uniao = MPI_Wtime();
+    juntar_cursos_ads(&cursos_ads, num_processos);
+    if (config.por_grupo) juntar_mapa_grupos(&grupos, num_processos);
+    metricas.coletivas += MPI_Wtime() - inicio_uniao;
 
     if (rank_processo == 0) {
-        int capacidade = 0; //capacidade total de cursos ads (já salva espaço na memória, duplica qnd ela é atingida)
-        const char* caminho_arq1 = "DADOS/microdados2021_arq1.txt";
-        printf("Processo 0: Lendo a lista de cursos de ADS de '%s'...\n", caminho_arq1);
-        
-        FILE* arquivo = fopen(caminho_arq1, "r");
-        if (!arquivo) {
-            fprintf(stderr, "Erro fatal: não foi possível abrir '%s'.\n", caminho_arq1);
-            MPI_Abort(MPI_COMM_WORLD, 1);
+        printf("Encontrou %d cursos únicos (índice: %s).\n", cursos_ads.quantidade, cursos_ads.tipo == INDICE_BITMAP ? "bitmap" : "hash");
+        if (config.por_grupo) {
+            printf("Mapeou %d cursos em %d grupos (mapa: %s).\n", grupos.quantidade, grupos.num_grupos,
+                   grupos.tipo == INDICE_BITMAP ? "vetor denso" : "hash");
         }
+    }
+    // Sem nenhum par (CO_CURSO, CO_GRUPO) válido no arq1 não há tabela por grupo a montar. O mapa é o mesmo
+    // em todos os processos depois da união, então todos saem juntos.
+    if (config.por_grupo && grupos.num_grupos == 0) {
+        if (rank_processo == 0) fprintf(stderr, "Erro fatal: nenhum curso com CO_GRUPO foi encontrado em '%s'.\n", caminho_arq1);
+        indice_cursos_liberar(&cursos_ads);
+        mapa_grupos_liberar(&grupos);
+        MPI_Finalize();
+        return 1;
+    }
 
-        char linha[TAMANHO_MAX_LINHA];
-        fgets(linha, sizeof(linha), arquivo);
-
-        while (fgets(linha, sizeof(linha), arquivo)) {
-            int codigo_curso = 0, codigo_grupo = 0;
-            
-            // Lê os números puros do arquivo arq1.txt, pulando as colunas desnecessárias.
-            int itens_lidos = sscanf(linha, "%*[^;];%d;%*[^;];%*[^;];%*[^;];%d", &codigo_curso, &codigo_grupo);
-            
-            if (itens_lidos >= 2 && codigo_grupo == CODIGO_GRUPO_ADS) {
-                // Adiciona o curso somente se ele for ÚNICO.
-                if (!curso_esta_na_lista(codigo_curso, cursos_ads_lista, qtd_cursos_ads)) {
-                    if (qtd_cursos_ads == capacidade) {
-                        int nova_capacidade = (capacidade == 0) ? 100 : capacidade * 2;
-                        int* ponteiro_temp = realloc(cursos_ads_lista, nova_capacidade * sizeof(int));
-                        if (!ponteiro_temp) {
-                            fprintf(stderr, "Erro fatal: falha ao alocar memória.\n");
-                            free(cursos_ads_lista);
-                            MPI_Abort(MPI_COMM_WORLD, 1);
-                        }
-                        cursos_ads_lista = ponteiro_temp;
-                        capacidade = nova_capacidade;
-                    }
-                    cursos_ads_lista[qtd_cursos_ads++] = codigo_curso; //coloca o codigo no numero mais novo
-                }
+    MPI_Barrier(MPI_COMM_WORLD); 
+    if (rank_processo == 0) printf("\nIniciando a análise paralela dos arquivos de dados...\n\n");
+
+    const char* arquivos_de_dados[NUM_MAX_ARQUIVOS];
+    int num_arquivos_de_dados = 0;
+    if (config.cruzamento.num_dimensoes > 0) {
+        for (int d = 0; d < config.cruzamento.num_dimensoes; d++) arquivos_de_dados[num_arquivos_de_dados++] = config.cruzamento.arquivos[d];
+    } else {
+        num_arquivos_de_dados = perguntas_listar_arquivos(arquivos_de_dados, NUM_MAX_ARQUIVOS);
+    }
+
+    if (config.gerar_cache) { // cada processo converte alguns arquivos
+        for (int i = rank_processo; i < num_arquivos_de_dados; i += num_processos) {
+            if (gerar_cache_do_arquivo(arquivos_de_dados[i], config.modo_parser)) {
+                printf("Processo %d: cache de %s gerado.\n", rank_processo, arquivos_de_dados[i]);
+            } else {
+                fprintf(stderr, "Aviso: não foi possível gerar o cache de %s.\n", arquivos_de_dados[i]);
             }
         }
-        fclose(arquivo);
-        printf("Processo 0: Encontrou %d cursos únicos. Distribuindo para os outros processos...\n", qtd_cursos_ads);
+        MPI_Barrier(MPI_COMM_WORLD);
     }
 
-    MPI_Bcast(&qtd_cursos_ads, 1, MPI_INT, 0, MPI_COMM_WORLD);
-
-    if (rank_processo != 0) {
-        cursos_ads_lista = (int*)malloc(qtd_cursos_ads * sizeof(int));
-        if (cursos_ads_lista == NULL && qtd_cursos_ads > 0) {
-             fprintf(stderr, "Processo %d: falha ao alocar memória.\n", rank_processo);
-             MPI_Abort(MPI_COMM_WORLD, 1);
+    if (config.cruzamento.num_dimensoes > 0) {
+        TabelaCruzada tabela_cruzada;
+        double inicio_cruzamento = MPI_Wtime();
+        int ok = cruzamento_calcular(&config.cruzamento, &cursos_ads, config.modo_parser, config.usar_cache, rank_processo, num_processos,
+                                     &tabela_cruzada, &metricas);
+        metricas.trabalho += MPI_Wtime() - inicio_cruzamento;
+        if (rank_processo == 0) {
+            if (ok) {
+                double tempo_fim = MPI_Wtime();
+                imprimir_resultados_finais(cursos_ads.quantidade, NULL, &config.cruzamento, &tabela_cruzada);
+                printf("---------------------------------------------------\n");
+                printf("Análise concluída em %.4f segundos.\n", tempo_fim - tempo_inicio);
+            } else {
+                fprintf(stderr, "Erro fatal: os arquivos do cruzamento não puderam ser abertos.\n");
+            }
         }
+        // O cruzamento divide as linhas em fatias iguais entre os processos, sem threads nem chunks.
+        if (ok) metricas_relatar(&metricas, arquivos_de_dados, num_arquivos_de_dados, rank_processo, num_processos, "estático", 1, config.arquivo_metricas);
+        cruzamento_liberar(&tabela_cruzada);
+        indice_cursos_liberar(&cursos_ads);
+        MPI_Finalize();
+        return ok ? 0 : 1;
     }
-    MPI_Bcast(cursos_ads_lista, qtd_cursos_ads, MPI_INT, 0, MPI_COMM_WORLD);
-    
-    MPI_Barrier(MPI_COMM_WORLD); 
-    if (rank_processo == 0) printf("\nIniciando a análise paralela dos arquivos de dados...\n\n");
 
-    Resultados resultados_locais = {0}; // Inicializa todos os campos com 0
-    const char* arquivos_de_dados[] = {
-        "DADOS/microdados2021_arq5.txt", "DADOS/microdados2021_arq21.txt", "DADOS/microdados2021_arq24.txt",
-        "DADOS/microdados2021_arq25.txt", "DADOS/microdados2021_arq27.txt", "DADOS/microdados2021_arq28.txt",
-        "DADOS/microdados2021_arq29.txt"
-    };
-    int num_arquivos_de_dados = sizeof(arquivos_de_dados) / sizeof(arquivos_de_dados[0]);
+    // No modo por grupo, um bloco de contadores por CO_GRUPO; a redução continua sendo uma só.
+    SelecaoDeCursos selecao = { &cursos_ads, config.por_grupo ? &grupos : NULL, perguntas_num_contadores() };
+    int num_blocos = config.por_grupo ? grupos.num_grupos : 1;
 
-    for (int i = 0; i < num_arquivos_de_dados; ++i) { //fala qual arquivo esta analisando no momento
-        if (rank_processo == 0) printf("Analisando: %s...\n", arquivos_de_dados[i]);
-        processar_arquivo_de_dados(arquivos_de_dados[i], rank_processo, num_processos, cursos_ads_lista, qtd_cursos_ads, &resultados_locais); //passa variaveis vazias no final pra preencher elas (cursos_ads e o resultado locais)
-        MPI_Barrier(MPI_COMM_WORLD); 
+    Resultados resultados_locais;
+    resultados_criar(&resultados_locais, num_blocos); // Inicializa todos os contadores com 0
+    if (config.agendamento == AGENDAMENTO_DINAMICO) {
+        processar_dinamico(arquivos_de_dados, num_arquivos_de_dados, &config, rank_processo, num_processos, &selecao, &resultados_locais, &metricas);
+    } else {
+        processar_estatico(arquivos_de_dados, num_arquivos_de_dados, &config, rank_processo, num_processos, &selecao, &resultados_locais, &metricas);
     }
 
+    // Única sincronização do agendamento dinâmico: mede quanto cada processo ficou parado esperando o mais lento.
+    double inicio_espera = MPI_Wtime();
+    MPI_Barrier(MPI_COMM_WORLD);
+    metricas.espera += MPI_Wtime() - inicio_espera;
+
     if (rank_processo == 0) printf("\nAnálise paralela concluída. Agregando resultados...\n");
 
-    Resultados resultados_finais = {0};
-    int num_elementos_struct = sizeof(Resultados) / sizeof(long long);
-    MPI_Reduce(&resultados_locais, &resultados_finais, num_elementos_struct, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD); //junta os dados e insere em resultados finais
+    Resultados resultados_finais;
+    resultados_criar(&resultados_finais, num_blocos);
+    double inicio_reducao = MPI_Wtime();
+    MPI_Reduce(resultados_locais.contadores, resultados_finais.contadores, resultados_locais.num_contadores, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD); //junta os dados e insere em resultados finais
+    metricas.coletivas += MPI_Wtime() - inicio_reducao;
 
     if (rank_processo == 0) {
         double tempo_fim = MPI_Wtime();
-        imprimir_resultados_finais(qtd_cursos_ads, &resultados_finais);
+        if (config.por_grupo) {
+            imprimir_resultados_por_grupo(&grupos, &resultados_finais);
+        } else {
+            imprimir_resultados_finais(cursos_ads.quantidade, &resultados_finais, NULL, NULL);
+        }
         printf("---------------------------------------------------\n");
         printf("Análise concluída em %.4f segundos.\n", tempo_fim - tempo_inicio);
+
+        const int grupo_ads = CODIGO_GRUPO_ADS;
+        ContagensPorGrupo contagens = { 1, &grupo_ads, &cursos_ads.quantidade, resultados_finais.contadores };
+        if (config.por_grupo) {
+            contagens.num_grupos = grupos.num_grupos;
+            contagens.codigos_grupo = grupos.codigos_grupo;
+            contagens.cursos_por_grupo = grupos.cursos_por_grupo;
+        }
+        if (config.arquivo_csv && !exportar_csv(config.arquivo_csv, &contagens)) fprintf(stderr, "Aviso: não foi possível gravar '%s'.\n", config.arquivo_csv);
+        if (config.arquivo_json && !exportar_json(config.arquivo_json, &contagens)) fprintf(stderr, "Aviso: não foi possível gravar '%s'.\n", config.arquivo_json);
     }
+    metricas_relatar(&metricas, arquivos_de_dados, num_arquivos_de_dados, rank_processo, num_processos,
+                     config.agendamento == AGENDAMENTO_DINAMICO ? "dinâmico" : "estático", config.num_threads, config.arquivo_metricas);
     
-    free(cursos_ads_lista);
+    resultados_liberar(&resultados_locais);
+    resultados_liberar(&resultados_finais);
+    indice_cursos_liberar(&cursos_ads);
+    mapa_grupos_liberar(&grupos);
     MPI_Finalize();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "parser_enade.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#define TAMANHO_MAX_LINHA_SSCANF 2048
+#define MAX_SEPARADORES 5 // a linha do arq1 usa os cinco primeiros ';'
+
+static inline int eh_espaco(char c) { // isspace() do locale "C", como o sscanf
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Localiza o fim da linha e os primeiros 'max' separadores ';' dela, byte a byte.
+// Retorna quantos separadores foram encontrados; *fim_linha aponta para o '\n' (ou para 'fim').
+static int indexar_linha_escalar(const char* p, const char* fim, const char** separadores, int max, const char** fim_linha) {
+    int encontrados = 0;
+    for (; p < fim && *p != '\n'; p++) {
+        if (*p == ';' && encontrados < max) separadores[encontrados++] = p;
+    }
+    *fim_linha = p;
+    return encontrados;
+}
+
+#if defined(__AVX2__)
+#define LARGURA_SIMD 32
+typedef __m256i VetorSimd;
+#define simd_carregar(p) _mm256_loadu_si256((const __m256i*)(p))
+#define simd_repetir(c) _mm256_set1_epi8(c)
+#define simd_mascara_iguais(a, b) ((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8((a), (b))))
+#elif defined(__SSE2__)
+#define LARGURA_SIMD 16
+typedef __m128i VetorSimd;
+#define simd_carregar(p) _mm_loadu_si128((const __m128i*)(p))
+#define simd_repetir(c) _mm_set1_epi8(c)
+#define simd_mascara_iguais(a, b) ((unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8((a), (b))))
+#endif
+
+#ifdef LARGURA_SIMD
+// Mesma saída que indexar_linha_escalar, comparando LARGURA_SIMD bytes por vez: cada bloco gera
+// uma máscara de bits com as posições de '\n' e outra com as de ';'.
+static int indexar_linha_simd(const char* p, const char* fim, const char** separadores, int max, const char** fim_linha) {
+    const VetorSimd quebra = simd_repetir('\n');
+    const VetorSimd ponto_e_virgula = simd_repetir(';');
+    int encontrados = 0;
+
+    while (fim - p >= LARGURA_SIMD) {
+        VetorSimd bloco = simd_carregar(p);
+        unsigned mascara_quebra = simd_mascara_iguais(bloco, quebra);
+        unsigned mascara_separador = simd_mascara_iguais(bloco, ponto_e_virgula);
+
+        if (mascara_quebra) { // só contam os ';' antes do '\n'
+            mascara_separador &= (1u << __builtin_ctz(mascara_quebra)) - 1u;
+        }
+        while (mascara_separador && encontrados < max) {
+            separadores[encontrados++] = p + __builtin_ctz(mascara_separador);
+            mascara_separador &= mascara_separador - 1u;
+        }
+        if (mascara_quebra) {
+            *fim_linha = p + __builtin_ctz(mascara_quebra);
+            return encontrados;
+        }
+        p += LARGURA_SIMD;
+    }
+
+    // Resto do buffer menor que um vetor.
+    int restantes = indexar_linha_escalar(p, fim, separadores + encontrados, max - encontrados, fim_linha);
+    return encontrados + restantes;
+}
+#endif
+
+static int indexar_linha(const char* p, const char* fim, ModoParser modo, const char** separadores, int max, const char** fim_linha) {
+#ifdef LARGURA_SIMD
+    if (modo == PARSER_SIMD) return indexar_linha_simd(p, fim, separadores, max, fim_linha);
+#else
+    (void)modo;
+#endif
+    return indexar_linha_escalar(p, fim, separadores, max, fim_linha);
+}
+
+// Converte um inteiro como o "%d" do sscanf (pula espaços, aceita sinal, satura como strtol e trunca
+// para int). Retorna o ponteiro logo após o último dígito, ou NULL se não houver dígitos.
+static const char* ler_inteiro(const char* p, const char* fim, int* valor) {
+    while (p < fim && eh_espaco(*p)) p++;
+    int negativo = 0;
+    if (p < fim && (*p == '+' || *p == '-')) negativo = (*p++ == '-');
+    if (p >= fim || *p < '0' || *p > '9') return NULL;
+
+    unsigned long long magnitude = 0;
+    int estourou = 0;
+    for (; p < fim && *p >= '0' && *p <= '9'; p++) {
+        unsigned digito = (unsigned)(*p - '0');
+        if (magnitude > (ULLONG_MAX - digito) / 10) estourou = 1;
+        else magnitude = magnitude * 10 + digito;
+    }
+
+    long resultado;
+    if (negativo) resultado = (estourou || magnitude > (unsigned long long)LONG_MAX + 1) ? LONG_MIN : (long)(0 - magnitude);
+    else resultado = (estourou || magnitude > (unsigned long long)LONG_MAX) ? LONG_MAX : (long)magnitude;
+    *valor = (int)resultado;
+    return p;
+}
+
+// Cópia terminada em '\0' da linha, para os caminhos que usam sscanf.
+static void copiar_linha(const char* linha, const char* fim_linha, char* destino) {
+    size_t tamanho = (size_t)(fim_linha - linha);
+    if (tamanho > TAMANHO_MAX_LINHA_SSCANF - 1) tamanho = TAMANHO_MAX_LINHA_SSCANF - 1;
+    memcpy(destino, linha, tamanho);
+    destino[tamanho] = '\0';
+}
+
+static const char* proxima_linha(const char* fim_linha, const char* fim) {
+    return (fim_linha < fim) ? fim_linha + 1 : fim;
+}
+
+const char* parser_linha_dados(const char* linha, const char* fim, ModoParser modo, RegistroDados* registro) {
+    registro->ano = 0;
+    registro->codigo_curso = 0;
+    registro->resposta = 0;
+
+    const char* separadores[2];
+    const char* fim_linha;
+    int num_separadores = indexar_linha(linha, fim, modo, separadores, 2, &fim_linha);
+
+    if (modo == PARSER_SSCANF) {
+        char copia[TAMANHO_MAX_LINHA_SSCANF];
+        char resposta_str[2] = {0};
+        copiar_linha(linha, fim_linha, copia);
+        sscanf(copia, "%d;%d;\"%1s\"", &registro->ano, &registro->codigo_curso, resposta_str);
+        registro->resposta = resposta_str[0];
+        return proxima_linha(fim_linha, fim);
+    }
+
+    // Cada campo numérico tem que terminar exatamente no próximo ';', senão o sscanf pararia ali.
+    const char* p = ler_inteiro(linha, fim_linha, &registro->ano);
+    if (!p || num_separadores < 1 || p != separadores[0]) return proxima_linha(fim_linha, fim);
+    p = ler_inteiro(separadores[0] + 1, fim_linha, &registro->codigo_curso);
+    if (!p || num_separadores < 2 || p != separadores[1]) return proxima_linha(fim_linha, fim);
+
+    // Aspas de abertura e então o primeiro caractere que não seja espaço ("%1s").
+    p = separadores[1] + 1;
+    if (p < fim_linha && *p == '"') {
+        for (p++; p < fim_linha && eh_espaco(*p); p++) {}
+        if (p < fim_linha) registro->resposta = *p;
+    }
+    return proxima_linha(fim_linha, fim);
+}
+
+const char* parser_linha_arq1(const char* linha, const char* fim, ModoParser modo, RegistroArq1* registro) {
+    registro->codigo_curso = 0;
+    registro->codigo_grupo = 0;
+    registro->itens_lidos = 0;
+
+    const char* separadores[MAX_SEPARADORES];
+    const char* fim_linha;
+    int num_separadores = indexar_linha(linha, fim, modo, separadores, MAX_SEPARADORES, &fim_linha);
+
+    if (modo == PARSER_SSCANF) {
+        char copia[TAMANHO_MAX_LINHA_SSCANF];
+        copiar_linha(linha, fim_linha, copia);
+        int itens = sscanf(copia, "%*[^;];%d;%*[^;];%*[^;];%*[^;];%d", &registro->codigo_curso, &registro->codigo_grupo);
+        registro->itens_lidos = (itens > 0) ? itens : 0;
+        return proxima_linha(fim_linha, fim);
+    }
+
+    // "%*[^;]" exige pelo menos um caractere antes do ';'.
+    if (num_separadores < 1 || separadores[0] == linha) return proxima_linha(fim_linha, fim);
+    const char* p = ler_inteiro(separadores[0] + 1, fim_linha, &registro->codigo_curso);
+    if (!p) return proxima_linha(fim_linha, fim);
+    registro->itens_lidos = 1;
+    if (num_separadores < 2 || p != separadores[1]) return proxima_linha(fim_linha, fim);
+
+    for (int i = 2; i < MAX_SEPARADORES; i++) { // colunas 3, 4 e 5 não podem ser vazias
+        if (num_separadores <= i || separadores[i] == separadores[i - 1] + 1) return proxima_linha(fim_linha, fim);
+    }
+    if (ler_inteiro(separadores[MAX_SEPARADORES - 1] + 1, fim_linha, &registro->codigo_grupo)) registro->itens_lidos = 2;
+    return proxima_linha(fim_linha, fim);
+}
+
+const char* parser_nome_modo(ModoParser modo) {
+    switch (modo) {
+        case PARSER_SIMD: return "simd";
+        case PARSER_ESCALAR: return "escalar";
+        default: return "sscanf";
+    }
+}
+
+const char* parser_instrucoes_simd(void) {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "escalar";
+#endif
+}
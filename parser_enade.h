@@ -0,0 +1,36 @@
+#ifndef PARSER_ENADE_H
+#define PARSER_ENADE_H
+
+// Parser dos campos separados por ';' dos microdados, lendo direto do buffer (sem cópia nem sscanf).
+// As linhas são localizadas com SSE2/AVX2 quando disponíveis (com fallback escalar), e os resultados
+// são os mesmos que os padrões de sscanf usados originalmente, inclusive em linhas malformadas:
+//   dados: "%d;%d;\"%1s\""                      (NU_ANO;CO_CURSO;"resposta")
+//   arq1:  "%*[^;];%d;%*[^;];%*[^;];%*[^;];%d"   (CO_CURSO na 2ª coluna, CO_GRUPO na 6ª)
+
+typedef enum {
+    PARSER_SIMD,    // busca de ';' e '\n' com SSE2/AVX2
+    PARSER_ESCALAR, // mesma lógica, byte a byte
+    PARSER_SSCANF   // implementação original, mantida como referência
+} ModoParser;
+
+typedef struct {
+    int ano;
+    int codigo_curso;
+    char resposta;      // 0 quando a linha não tem resposta
+} RegistroDados;
+
+typedef struct {
+    int codigo_curso;
+    int codigo_grupo;
+    int itens_lidos;    // como o retorno do sscanf: 2 quando os dois campos foram lidos
+} RegistroArq1;
+
+// Lê a linha que começa em 'linha' (o buffer termina em 'fim') e devolve o início da próxima.
+const char* parser_linha_dados(const char* linha, const char* fim, ModoParser modo, RegistroDados* registro);
+const char* parser_linha_arq1(const char* linha, const char* fim, ModoParser modo, RegistroArq1* registro);
+
+const char* parser_nome_modo(ModoParser modo);
+// Conjunto de instruções usado pelo PARSER_SIMD nesta compilação ("AVX2", "SSE2" ou "escalar").
+const char* parser_instrucoes_simd(void);
+
+#endif
@@ -0,0 +1,74 @@
+#include "perguntas_enade.h"
+
+#include <string.h>
+
+const Pergunta PERGUNTAS[] = {
+    { "DADOS/microdados2021_arq5.txt", "Qual é a quantidade de estudantes matriculados?",
+      PERGUNTA_CONTAGEM, "", {0}, 0 },
+    { "DADOS/microdados2021_arq5.txt", "Qual é a porcentagem de estudante do sexo Feminino?",
+      PERGUNTA_PROPORCAO, "F", {0}, 0 },
+    { "DADOS/microdados2021_arq24.txt", "Qual é a porcentagem de estudantes que cursaram o ensino técnico no ensino médio?",
+      PERGUNTA_PROPORCAO, "B", {0}, 0 },
+    // Conta tudo que não for "não" (A), branco ou ponto, inclusive linhas sem resposta.
+    { "DADOS/microdados2021_arq21.txt", "Qual é o percentual de alunos provenientes de ações afirmativas?",
+      PERGUNTA_PROPORCAO, "A .", {0}, 1 },
+    { "DADOS/microdados2021_arq25.txt", "Dos estudantes, quem deu incentivo para este estudante cursar o ADS?",
+      PERGUNTA_DISTRIBUICAO, "BCDFEGA",
+      { "Pais:                 ", "Outros familiares:    ", "Professores:          ", "Colegas/Amigos:       ",
+        "Líder religioso:      ", "Outras pessoas:       ", "Ninguém:              " }, 0 },
+    { "DADOS/microdados2021_arq27.txt", "Quantos estudantes apresentaram familiares com o curso superior concluído?",
+      PERGUNTA_DISTRIBUICAO, "AB", { "Sim: ", "Não: " }, 0 },
+    { "DADOS/microdados2021_arq28.txt", "Quantos livros os alunos leram no ano do ENADE?",
+      PERGUNTA_DISTRIBUICAO, "ABCDE",
+      { "Nenhum:        ", "1 ou 2:        ", "3 a 5:         ", "6 a 8:         ", "Mais de 8:     " }, 0 },
+    { "DADOS/microdados2021_arq29.txt", "Quantas horas na semana os estudantes se dedicaram aos estudos?",
+      PERGUNTA_DISTRIBUICAO, "ABCDE",
+      { "Nenhuma (só aulas): ", "1 a 3 horas:        ", "4 a 7 horas:        ", "8 a 12 horas:       ", "Mais de 12 horas:   " }, 0 },
+};
+
+const int NUM_PERGUNTAS = sizeof(PERGUNTAS) / sizeof(PERGUNTAS[0]);
+
+int perguntas_primeiro_contador(int pergunta) {
+    int primeiro = 0;
+    for (int i = 0; i < pergunta; i++) primeiro += (int)strlen(PERGUNTAS[i].letras) + 1;
+    return primeiro;
+}
+
+int perguntas_num_contadores(void) {
+    return perguntas_primeiro_contador(NUM_PERGUNTAS);
+}
+
+int perguntas_contador_outras(int pergunta) {
+    return perguntas_primeiro_contador(pergunta) + (int)strlen(PERGUNTAS[pergunta].letras);
+}
+
+int perguntas_listar_arquivos(const char** arquivos, int max) {
+    int quantidade = 0;
+    for (int i = 0; i < NUM_PERGUNTAS; i++) {
+        int repetido = 0;
+        for (int j = 0; j < quantidade; j++) {
+            if (strcmp(arquivos[j], PERGUNTAS[i].arquivo) == 0) repetido = 1;
+        }
+        if (!repetido && quantidade < max) arquivos[quantidade++] = PERGUNTAS[i].arquivo;
+    }
+    return quantidade;
+}
+
+int perguntas_montar_despacho(const char* arquivo, TabelaDespacho* despacho) {
+    memset(despacho, 0, sizeof(*despacho));
+    int perguntas_do_arquivo = 0;
+
+    for (int i = 0; i < NUM_PERGUNTAS; i++) {
+        if (strcmp(PERGUNTAS[i].arquivo, arquivo) != 0 || perguntas_do_arquivo == MAX_PERGUNTAS_POR_ARQUIVO) continue;
+        perguntas_do_arquivo++;
+
+        int primeiro = perguntas_primeiro_contador(i);
+        const char* letras = PERGUNTAS[i].letras;
+        for (int byte = 0; byte < 256; byte++) {
+            const char* letra = (byte != 0) ? strchr(letras, byte) : NULL;
+            int contador = letra ? primeiro + (int)(letra - letras) : perguntas_contador_outras(i);
+            despacho->contadores[byte][despacho->quantidade[byte]++] = (short)contador;
+        }
+    }
+    return perguntas_do_arquivo;
+}
@@ -0,0 +1,47 @@
+#ifndef PERGUNTAS_ENADE_H
+#define PERGUNTAS_ENADE_H
+
+// Registro declarativo das perguntas respondidas pela análise. Cada pergunta diz de qual arquivo vem,
+// quais letras de resposta têm contador próprio (com seus rótulos) e como o resultado é apresentado.
+// Os contadores de todas as perguntas ficam num único vetor: a pergunta i ocupa
+// [primeiro_contador[i], primeiro_contador[i] + strlen(letras)] e o último desses é o das respostas fora de 'letras'.
+
+#define MAX_OPCOES 8
+#define MAX_PERGUNTAS_POR_ARQUIVO 4
+
+typedef enum {
+    PERGUNTA_CONTAGEM,    // conta todas as linhas (base dos percentuais das proporções)
+    PERGUNTA_PROPORCAO,   // quantos e que % do total marcaram as letras listadas (ou qualquer outra, se conta_outras)
+    PERGUNTA_DISTRIBUICAO // contagem e % de cada letra entre as respostas válidas, mais as nulas/inválidas
+} TipoPergunta;
+
+typedef struct {
+    const char* arquivo;
+    const char* enunciado;
+    TipoPergunta tipo;
+    const char* letras;
+    const char* rotulos[MAX_OPCOES]; // um por letra, usados só pela distribuição
+    int conta_outras;
+} Pergunta;
+
+// Para cada byte de resposta, os contadores que uma linha de ADS incrementa naquele arquivo.
+typedef struct {
+    unsigned char quantidade[256];
+    short contadores[256][MAX_PERGUNTAS_POR_ARQUIVO];
+} TabelaDespacho;
+
+extern const Pergunta PERGUNTAS[];
+extern const int NUM_PERGUNTAS;
+
+// Tamanho do vetor de contadores e posição do primeiro contador de cada pergunta.
+int perguntas_num_contadores(void);
+int perguntas_primeiro_contador(int pergunta);
+// Índice do contador das respostas fora de 'letras' da pergunta.
+int perguntas_contador_outras(int pergunta);
+
+// Arquivos distintos do registro, na ordem em que aparecem. Retorna quantos foram escritos em 'arquivos'.
+int perguntas_listar_arquivos(const char** arquivos, int max);
+// Monta a tabela de despacho de um arquivo. Retorna quantas perguntas usam o arquivo (0 se nenhuma).
+int perguntas_montar_despacho(const char* arquivo, TabelaDespacho* despacho);
+
+#endif
@@ -0,0 +1,207 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parser_enade.h"
+
+// Verificação diferencial do parser: lê as mesmas linhas com os três modos (simd, escalar e sscanf)
+// e confere se todos devolvem os mesmos campos e o mesmo início da próxima linha. Usa os casos
+// documentados (estouro de inteiro, colunas vazias no "%*[^;]", espaços antes da resposta, última
+// linha sem '\n') e depois linhas sorteadas a partir de um alfabeto com ';', aspas, sinais e espaços.
+// Compilação: gcc -O2 -march=native -o verifica_parser_enade verifica_parser_enade.c parser_enade.c
+// Uso: ./verifica_parser_enade [linhas sorteadas] [semente]
+
+#define LINHAS_SORTEADAS 200000
+#define SEMENTE_PADRAO 2021
+#define TAMANHO_MAX_SORTEADA 200 // bem abaixo do limite de cópia do caminho com sscanf
+
+static const ModoParser modos[] = {PARSER_SIMD, PARSER_ESCALAR, PARSER_SSCANF};
+#define NUM_MODOS ((int)(sizeof(modos) / sizeof(modos[0])))
+
+static const char* casos_dados[] = {
+    "2021;12345;\"A\"\n",
+    "2021;12345;\"A\"",                              // sem '\n' no fim do buffer
+    "2021;12345;\"A\"\r\n",
+    "2021;12345;\" B\"\n",                           // espaço antes da resposta
+    "2021;12345;\"\t\t C\"\n",
+    "2021;12345;\"   \"\n",                          // só espaços: sem resposta
+    "2021;12345;\"\"\n",
+    "2021;12345;A\n",                                // sem aspas
+    "2021;12345;\n",
+    "2021;12345\n",
+    "2021\n",
+    "\n",
+    ";;\n",
+    "  2021; \t12345;\"D\"\n",                       // espaços antes dos números
+    "+2021;-12345;\"E\"\n",
+    "-;12345;\"E\"\n",
+    "2021 ;12345;\"E\"\n",                           // número não termina no ';'
+    "2021;12345 ;\"E\"\n",
+    "2021;12x45;\"E\"\n",
+    "2147483647;2147483648;\"F\"\n",                 // limites e estouro de int
+    "-2147483648;-2147483649;\"F\"\n",
+    "99999999999999999999;12345;\"G\"\n",            // estouro de long
+    "-99999999999999999999;12345;\"G\"\n",
+    "9223372036854775807;9223372036854775808;\"G\"\n",
+    "18446744073709551615;18446744073709551616;\"G\"\n",
+    "000000000000000000000000002021;0000012345;\"H\"\n",
+    "2021;12345;\"A\";resto;da;linha\n",
+};
+
+static const char* casos_arq1[] = {
+    "2021;12345;1;2;3;72\n",
+    "2021;12345;1;2;3;72",                           // sem '\n' no fim do buffer
+    "2021;12345;1;2;3;72\r\n",
+    ";12345;1;2;3;72\n",                             // 1ª coluna vazia
+    "2021;12345;;2;3;72\n",                          // colunas vazias no meio
+    "2021;12345;1;;3;72\n",
+    "2021;12345;1;2;;72\n",
+    "2021;12345;1;2;3;\n",
+    "2021;12345;1;2;3\n",
+    "2021;12345\n",
+    "2021;12345 ;1;2;3;72\n",
+    "2021; 12345;1;2;3;  72\n",
+    "2021;;1;2;3;72\n",
+    "2021;x;1;2;3;72\n",
+    "2021;12345;1;2;3;-72\n",
+    "2021;99999999999999999999;1;2;3;72\n",          // estouro
+    "2021;12345;1;2;3;-99999999999999999999\n",
+    "2021;2147483648;1;2;3;4294967297\n",
+    "a;b;c;d;e;f;g;h\n",
+    "2021;12345;1;2;3;72;mais;colunas\n",
+    "\n",
+    ";;;;;\n",
+};
+
+// Uma linha de cada caso, comparando os modos. Retorna o número de divergências.
+static int conferir_dados(const char* linha, const char* fim, const char* descricao) {
+    RegistroDados registros[NUM_MODOS];
+    const char* proximas[NUM_MODOS];
+    for (int m = 0; m < NUM_MODOS; m++) proximas[m] = parser_linha_dados(linha, fim, modos[m], &registros[m]);
+
+    for (int m = 1; m < NUM_MODOS; m++) {
+        if (proximas[m] == proximas[0] && registros[m].ano == registros[0].ano &&
+            registros[m].codigo_curso == registros[0].codigo_curso && registros[m].resposta == registros[0].resposta) {
+            continue;
+        }
+        fprintf(stderr, "Divergência em dados (%s): \"%.*s\"\n", descricao, (int)(fim - linha), linha);
+        for (int k = 0; k < NUM_MODOS; k++) {
+            fprintf(stderr, "  %-8s ano=%d curso=%d resposta=%d proxima=+%td\n", parser_nome_modo(modos[k]), registros[k].ano,
+                    registros[k].codigo_curso, registros[k].resposta, proximas[k] - linha);
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static int conferir_arq1(const char* linha, const char* fim, const char* descricao) {
+    RegistroArq1 registros[NUM_MODOS];
+    const char* proximas[NUM_MODOS];
+    for (int m = 0; m < NUM_MODOS; m++) proximas[m] = parser_linha_arq1(linha, fim, modos[m], &registros[m]);
+
+    for (int m = 1; m < NUM_MODOS; m++) {
+        // Como no sscanf, o CO_GRUPO só vale quando os dois itens foram lidos.
+        if (proximas[m] == proximas[0] && registros[m].itens_lidos == registros[0].itens_lidos &&
+            (registros[0].itens_lidos < 1 || registros[m].codigo_curso == registros[0].codigo_curso) &&
+            (registros[0].itens_lidos < 2 || registros[m].codigo_grupo == registros[0].codigo_grupo)) {
+            continue;
+        }
+        fprintf(stderr, "Divergência em arq1 (%s): \"%.*s\"\n", descricao, (int)(fim - linha), linha);
+        for (int k = 0; k < NUM_MODOS; k++) {
+            fprintf(stderr, "  %-8s itens=%d curso=%d grupo=%d proxima=+%td\n", parser_nome_modo(modos[k]),
+                    registros[k].itens_lidos, registros[k].codigo_curso, registros[k].codigo_grupo, proximas[k] - linha);
+        }
+        return 1;
+    }
+    return 0;
+}
+
+// Cada caso vai sozinho num buffer alocado do tamanho exato, para que uma leitura além de 'fim'
+// apareça no valgrind ou com -fsanitize=address.
+static int conferir_casos(const char** casos, int num_casos, int arq1) {
+    int divergencias = 0;
+    for (int i = 0; i < num_casos; i++) {
+        size_t tamanho = strlen(casos[i]);
+        char* buffer = malloc(tamanho ? tamanho : 1);
+        if (!buffer) {
+            fprintf(stderr, "Falha ao alocar memória.\n");
+            exit(1);
+        }
+        memcpy(buffer, casos[i], tamanho);
+        divergencias += arq1 ? conferir_arq1(buffer, buffer + tamanho, "caso fixo") : conferir_dados(buffer, buffer + tamanho, "caso fixo");
+        free(buffer);
+    }
+    return divergencias;
+}
+
+// Sorteia uma linha: ora no formato esperado com campos trocados, ora caracteres soltos do alfabeto.
+static size_t sortear_linha(char* destino, int arq1) {
+    static const char alfabeto[] = "0123456789;;;\"\"  \t-+xA\r";
+    size_t tamanho = 0;
+    if (rand() % 2) {
+        int colunas = arq1 ? 6 : 3;
+        for (int c = 0; c < colunas; c++) {
+            if (c > 0) destino[tamanho++] = ';';
+            switch (rand() % 8) {
+                case 0: break; // coluna vazia
+                case 1: tamanho += (size_t)sprintf(destino + tamanho, "%s", (rand() % 2) ? "99999999999999999999" : "-2147483649"); break;
+                case 2: tamanho += (size_t)sprintf(destino + tamanho, "%*s%d", rand() % 3, "", rand()); break;
+                case 3: tamanho += (size_t)sprintf(destino + tamanho, "\"%*s%c\"", rand() % 3, "", 'A' + rand() % 5); break;
+                default: tamanho += (size_t)sprintf(destino + tamanho, "%d", rand() % 100000); break;
+            }
+        }
+        if (rand() % 4 == 0) destino[tamanho++] = alfabeto[rand() % (sizeof(alfabeto) - 1)];
+    } else {
+        size_t alvo = (size_t)(rand() % 40);
+        while (tamanho < alvo) destino[tamanho++] = alfabeto[rand() % (sizeof(alfabeto) - 1)];
+    }
+    return tamanho;
+}
+
+// Junta as linhas sorteadas num buffer só, como um bloco do leitor, e percorre com os três modos.
+static int conferir_sorteadas(long linhas, int arq1) {
+    char* buffer = malloc((size_t)linhas * (TAMANHO_MAX_SORTEADA + 1));
+    if (!buffer) {
+        fprintf(stderr, "Falha ao alocar memória.\n");
+        exit(1);
+    }
+    size_t tamanho = 0;
+    for (long i = 0; i < linhas; i++) {
+        tamanho += sortear_linha(buffer + tamanho, arq1);
+        if (i + 1 < linhas || rand() % 2) buffer[tamanho++] = '\n'; // às vezes a última fica sem '\n'
+    }
+
+    int divergencias = 0;
+    const char* fim = buffer + tamanho;
+    for (const char* linha = buffer; linha < fim && divergencias < 10;) {
+        divergencias += arq1 ? conferir_arq1(linha, fim, "sorteada") : conferir_dados(linha, fim, "sorteada");
+        linha = arq1 ? parser_linha_arq1(linha, fim, PARSER_SSCANF, &(RegistroArq1){0})
+                     : parser_linha_dados(linha, fim, PARSER_SSCANF, &(RegistroDados){0});
+    }
+    free(buffer);
+    return divergencias;
+}
+
+int main(int argc, char** argv) {
+    long linhas = (argc > 1) ? atol(argv[1]) : LINHAS_SORTEADAS;
+    unsigned semente = (argc > 2) ? (unsigned)atol(argv[2]) : SEMENTE_PADRAO;
+    srand(semente);
+    printf("Parser SIMD: %s. %ld linhas sorteadas por formato, semente %u.\n", parser_instrucoes_simd(), linhas, semente);
+
+    int divergencias_dados = conferir_casos(casos_dados, (int)(sizeof(casos_dados) / sizeof(casos_dados[0])), 0);
+    int divergencias_arq1 = conferir_casos(casos_arq1, (int)(sizeof(casos_arq1) / sizeof(casos_arq1[0])), 1);
+    if (linhas > 0) {
+        divergencias_dados += conferir_sorteadas(linhas, 0);
+        divergencias_arq1 += conferir_sorteadas(linhas, 1);
+    }
+
+    printf("%-8s %10s %14s\n", "Formato", "Casos", "Divergências");
+    printf("%-8s %10zu %14d\n", "dados", sizeof(casos_dados) / sizeof(casos_dados[0]) + (size_t)linhas, divergencias_dados);
+    printf("%-8s %10zu %14d\n", "arq1", sizeof(casos_arq1) / sizeof(casos_arq1[0]) + (size_t)linhas, divergencias_arq1);
+    if (divergencias_dados || divergencias_arq1) {
+        fprintf(stderr, "Os modos do parser divergem.\n");
+        return 1;
+    }
+    printf("Os três modos concordam.\n");
+    return 0;
+}